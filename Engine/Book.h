@@ -0,0 +1,104 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "MoveGen.h"
+#include "Position.h"
+
+// Дебютная книга: для позиций начала партии записаны хорошие ходы с весами (чем ближе оценка хода
+// к лучшему, тем больше вес). Книгу строит команда book консольной программы (см. Tools/BookGen.h).
+// Движок берет ход из книги без поиска, поэтому первые ходы партии делаются мгновенно.
+//
+// Формат файла (числа - little-endian): заголовок BookFileHeader и count записей BookEntry,
+// отсортированных по хешу позиции (Position::hash, он включает очередь хода), а при равном хеше -
+// по убыванию веса. Файл отображается в память, и записи позиции ищутся двоичным поиском.
+
+const char BOOK_MAGIC[8] = {'C', 'K', 'R', 'S', 'B', 'K', '0', '1'};
+const uint32_t BOOK_VERSION = 1;
+
+struct BookFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t count;  // Число записей
+};
+
+// Запись книги - ход (вся серия взятий) в позиции с хешем key
+struct BookEntry
+{
+    uint64_t key;
+    BB captured;
+    uint8_t from, to;
+    uint16_t weight;
+};
+
+// Класс Book - дебютная книга, отображенная в память. После загрузки только читается.
+class Book
+{
+  public:
+    // Функция load() открывает файл книги path. Возвращает false, если файла нет или он поврежден.
+    bool load(const std::string &path)
+    {
+        entries = nullptr;
+        count = 0;
+        if (!file.open(path) || file.size() < sizeof(BookFileHeader))
+            return false;
+        BookFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || header.version != BOOK_VERSION ||
+            file.size() != sizeof(header) + uint64_t(header.count) * sizeof(BookEntry))
+        {
+            file.close();
+            return false;
+        }
+        // Заголовок занимает 16 байт, так что записи выровнены (отображение начинается с границы страницы)
+        entries = reinterpret_cast<const BookEntry *>(file.data() + sizeof(header));
+        count = header.count;
+        return true;
+    }
+
+    // Функция probe() выбирает ход из книги для позиции pos: при random - случайный с вероятностью,
+    // пропорциональной весу, иначе - ход с наибольшим весом. Ходы, которых нет в позиции
+    // (совпадение хеша у разных позиций), пропускаются. Возвращает false, если позиции нет в книге.
+    template <class Rng> bool probe(const Position &pos, const bool random, Rng &rng, Move &res) const
+    {
+        const BookEntry *first = std::lower_bound(entries, entries + count, pos.hash,
+                                                  [](const BookEntry &e, const uint64_t key) { return e.key < key; });
+        MoveList turns;
+        generate_turns(pos, turns);
+        std::vector<Move> moves;
+        std::vector<uint32_t> weights;
+        for (const BookEntry *e = first; e != entries + count && e->key == pos.hash; ++e)
+        {
+            for (const Move &turn : turns)
+            {
+                if (turn.from == e->from && turn.to == e->to && turn.captured == e->captured)
+                {
+                    moves.push_back(turn);
+                    weights.push_back(e->weight);
+                    break;
+                }
+            }
+        }
+        if (moves.empty())
+            return false;
+        if (!random)
+        {
+            res = moves[0];
+            return true;
+        }
+        std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+        res = moves[pick(rng)];
+        return true;
+    }
+
+  private:
+    MappedFile file;
+    const BookEntry *entries = nullptr;
+    size_t count = 0;
+};
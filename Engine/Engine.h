@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Book.h"
+#include "Position.h"
+#include "Search.h"
+#include "TTable.h"
+#include "Tablebase.h"
+#include "ThreadPool.h"
+
+// Структура EngineSettings - настройки бота. Движок не читает settings.json сам:
+// их заполняет клиент (Logic для окна, консольная программа - из аргументов командной строки).
+struct EngineSettings
+{
+    ScoringType scoring = ScoringType::NumberAndPotential;
+    Optimization optimization = Optimization::O1;
+    bool no_random = false;  // Детерминированный выбор хода
+    unsigned seed = 0;  // Зерно случайного выбора среди равных ходов
+    size_t hash_size_mb = 64;  // Размер таблицы транспозиций
+    int time_limit_ms = 0;  // Лимит времени на ход (0 - без ограничения)
+    unsigned threads = 1;  // Число потоков поиска (0 - по числу ядер)
+    int quiescence_limit = 8;  // Сколько ходов за горизонтом продолжать обязательные взятия (0 - не продолжать)
+    std::string tablebase_path;  // Файл эндшпильных баз (пусто - без баз)
+    std::string book_path;  // Файл дебютной книги (пусто - без книги)
+    std::string weights_path;  // Файл весов оценки Tuned (пусто - веса по умолчанию, см. EvalWeights)
+};
+
+// Класс Engine - движок бота без зависимостей от SDL и nlohmann/json.
+// Владеет таблицей транспозиций, потоками поиска и пулом потоков и ищет ход в позиции Position.
+// Поток обдумывания (см. start_pondering) работает с самим объектом, поэтому Engine не копируется
+// и не перемещается: владелец, которому это нужно, хранит его в std::unique_ptr.
+class Engine
+{
+  public:
+    explicit Engine(const EngineSettings &settings = EngineSettings())
+        : time_limit_ms(settings.time_limit_ms), no_random(settings.no_random), book_rng(settings.seed)
+    {
+        if (settings.optimization != Optimization::O0)
+            tt.resize(settings.hash_size_mb);
+        // Если файл баз не открылся, бот просто ищет без них (см. has_tablebase)
+        if (!settings.tablebase_path.empty())
+        {
+            tablebase = std::make_unique<Tablebase>();
+            if (!tablebase->load(settings.tablebase_path))
+                tablebase.reset();
+        }
+        if (!settings.book_path.empty())
+        {
+            book = std::make_unique<Book>();
+            if (!book->load(settings.book_path))
+                book.reset();
+        }
+        // Если файл весов не открылся, оценка Tuned работает с весами по умолчанию (см. has_weights)
+        if (!settings.weights_path.empty())
+            weights_loaded = weights.load(settings.weights_path);
+        unsigned threads = settings.threads;
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i)
+            searchers.emplace_back(settings.scoring, settings.optimization, settings.seed + i,
+                                   settings.no_random, settings.quiescence_limit,
+                                   tablebase.get(), weights);
+        // Lazy SMP дает разные результаты от запуска к запуску, поэтому в детерминированном режиме
+        // потоки вместо этого делят между собой ходы первого уровня
+        if (settings.no_random && threads > 1)
+            root_pool = std::make_unique<ThreadPool>(threads);
+    }
+
+    Engine(const Engine &) = delete;
+    Engine &operator=(const Engine &) = delete;
+
+    ~Engine()
+    {
+        stop_pondering();
+    }
+
+    // Функция find_best_turns() ищет лучший ход (вместе со всей серией взятий) для стороны pos.color.
+    // Поиск идет итеративным углублением до глубины max_depth (см. Searcher::search).
+    // При нескольких потоках используется Lazy SMP: все потоки ищут из одной позиции
+    // через общую таблицу транспозиций, вспомогательные потоки начинают с разных глубин
+    // и в своем порядке ходов, поэтому заполняют таблицу результатами, полезными основному.
+    // Ход берется у потока, завершившего самую глубокую итерацию (при равенстве - у основного).
+    // В режиме NoRandom потоки пула оценивают разные ходы первого уровня, и ход совпадает с однопоточным.
+    // Если позиция есть в дебютной книге, ход берется из нее без поиска: при NoRandom - самый частый,
+    // иначе - случайный с учетом весов. Если идет обдумывание, оно останавливается, и когда оно уже
+    // нашло ход для этой позиции на той же глубине, этот ход возвращается сразу.
+    // Поиск можно вызывать из отдельного потока: запрос остановки через cancel прерывает его в пределах
+    // долей миллисекунды (возвращается ход последней завершенной итерации или пустой список, если
+    // не завершилась даже первая), а progress вызывается
+    // из потока поиска после каждой итерации.
+    std::vector<move_pos> find_best_turns(const Position &pos, const int max_depth, std::stop_token cancel = {},
+                                          const ProgressCallback &progress = {})
+    {
+        stop_pondering();
+        for (Searcher &searcher : searchers)
+            searcher.stats = SearchStats();
+        best_searcher = 0;
+        Move book_move;
+        if (book && book->probe(pos, !no_random, book_rng, book_move))
+        {
+            searchers[0].root_score = 0;
+            ponder_results.clear();
+            return book_move.steps();
+        }
+        for (const PonderResult &ponder : ponder_results)
+        {
+            if (ponder.hash == pos.hash && ponder.depth == max_depth)
+            {
+                searchers[0].completed_depth = ponder.completed_depth;
+                searchers[0].root_score = ponder.score;
+                const std::vector<move_pos> turns = ponder.turns;
+                ponder_results.clear();
+                return turns;
+            }
+        }
+        ponder_results.clear();
+        tt.new_search();
+        const bool time_limited = time_limit_ms > 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms);
+
+        std::atomic<bool> stop(false);
+        const std::stop_callback on_cancel(cancel, [&stop]() { stop = true; });
+        searchers[0].progress = &progress;
+        if (root_pool)
+        {
+            auto res = searchers[0].search(pos, 0, max_depth, tt, stop, time_limited, deadline, root_pool.get(),
+                                           &searchers);
+            searchers[0].progress = nullptr;
+            return res;
+        }
+
+        std::vector<std::vector<move_pos>> results(searchers.size());
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < searchers.size(); ++i)
+        {
+            helpers.emplace_back([&, i]()
+            {
+                results[i] = searchers[i].search(pos, 1 + int(i % 2), max_depth, tt, stop, time_limited, deadline);
+            });
+        }
+        results[0] = searchers[0].search(pos, 0, max_depth, tt, stop, time_limited, deadline);
+        searchers[0].progress = nullptr;
+        // Основной поток закончил - останавливаем вспомогательные
+        stop = true;
+        for (auto &th : helpers)
+            th.join();
+
+        for (size_t i = 1; i < searchers.size(); ++i)
+        {
+            if (searchers[i].completed_depth > searchers[best_searcher].completed_depth)
+                best_searcher = i;
+        }
+        return results[best_searcher];
+    }
+
+    // Функция start_pondering() начинает обдумывание в фоновом потоке, пока соперник выбирает ход
+    // в позиции pos (pos.color - сторона соперника): для каждого его ответа ищется ход бота на глубину
+    // max_depth, сначала для ответа, который поиск бота считал лучшим (ход из таблицы транспозиций),
+    // затем для остальных. Законченные поиски запоминаются для find_best_turns(), а прерванные
+    // все равно заполняют таблицу транспозиций. Обдумывает только основной поток поиска
+    // (в режиме NoRandom - вместе с пулом, делящим ходы первого уровня).
+    void start_pondering(const Position &pos, const int max_depth)
+    {
+        stop_pondering();
+        ponder_results.clear();
+        ponder_stop = false;
+        ponder_thread = std::thread([this, pos, max_depth]() { ponder(pos, max_depth); });
+    }
+
+    // Функция stop_pondering() прерывает обдумывание и ждет остановки потока.
+    // Поиск проверяет флаг остановки в каждом узле, так что это занимает доли миллисекунды.
+    void stop_pondering()
+    {
+        if (!ponder_thread.joinable())
+            return;
+        ponder_stop = true;
+        ponder_thread.join();
+    }
+
+    // Функция new_game() очищает таблицу транспозиций и рейтинг истории, чтобы следующая партия
+    // не зависела от прошлых (окно для этого создает новый движок)
+    void new_game()
+    {
+        stop_pondering();
+        ponder_results.clear();
+        tt.clear();
+        for (Searcher &searcher : searchers)
+            searcher.new_game();
+    }
+
+    // Функция stats() возвращает счетчики последнего поиска, сложенные по всем потокам
+    SearchStats stats() const
+    {
+        SearchStats total;
+        for (const Searcher &searcher : searchers)
+            total += searcher.stats;
+        return total;
+    }
+
+    // Функция score() возвращает оценку хода, найденного последним поиском, для стороны, которая ходила
+    // (см. Eval.h; 0 - ход единственный или взят из книги)
+    int score() const
+    {
+        return searchers[best_searcher].root_score;
+    }
+
+    // Функция has_book() проверяет, загружена ли дебютная книга
+    bool has_book() const
+    {
+        return book != nullptr;
+    }
+
+    // Функция has_weights() проверяет, загружены ли веса оценки из файла
+    bool has_weights() const
+    {
+        return weights_loaded;
+    }
+
+    // Функция has_tablebase() проверяет, загружены ли эндшпильные базы
+    bool has_tablebase() const
+    {
+        return tablebase != nullptr;
+    }
+
+    // Функция completed_depth() возвращает глубину последней завершенной итерации основного потока
+    int completed_depth() const
+    {
+        return searchers[0].completed_depth;
+    }
+
+    // Функция find_turns() возвращает все допустимые ходы стороны pos.color с клеток маски from
+    // в формате move_pos. Если возможно взятие, возвращаются только взятия (взятие обязательно).
+    static std::vector<move_pos> find_turns(const Position &pos, bool &have_beats, const BB from = ~BB(0))
+    {
+        MoveList list;
+        have_beats = generate_moves(pos, list, from);
+        std::vector<move_pos> turns;
+        for (const Move &turn : list)
+            turns.push_back(turn.to_move_pos());
+        return turns;
+    }
+
+  private:
+    // Структура PonderResult - ход бота, найденный при обдумывании для позиции с хешем hash
+    struct PonderResult
+    {
+        uint64_t hash;
+        int depth;  // Запрошенная глубина поиска
+        int completed_depth;
+        int score;
+        std::vector<move_pos> turns;
+    };
+
+    // Функция ponder() - тело потока обдумывания (см. start_pondering)
+    void ponder(const Position &pos, const int max_depth)
+    {
+        MoveList replies;
+        generate_turns(pos, replies);
+        TTEntry entry;
+        if (tt.probe(pos.hash, entry))
+        {
+            for (int i = 0; i < replies.size; ++i)
+            {
+                if (replies[i] == entry.move)
+                {
+                    std::rotate(replies.begin(), replies.begin() + i, replies.begin() + i + 1);
+                    break;
+                }
+            }
+        }
+        tt.new_search();
+        for (const Move &reply : replies)
+        {
+            Position next = pos;
+            next.make_move(reply);
+            next.pass_turn();
+            const auto turns = searchers[0].search(next, 0, max_depth, tt, ponder_stop, false,
+                                                   std::chrono::steady_clock::time_point(), root_pool.get(),
+                                                   root_pool ? &searchers : nullptr);
+            if (ponder_stop)
+                return;
+            ponder_results.push_back(
+                PonderResult{next.hash, max_depth, searchers[0].completed_depth, searchers[0].root_score, turns});
+        }
+    }
+
+    TTable tt;  // Таблица транспозиций, общая для всех потоков
+    // Эндшпильные базы, общие для всех потоков (в куче, чтобы указатель у потоков не менялся при перемещении)
+    std::unique_ptr<Tablebase> tablebase;
+    std::unique_ptr<Book> book;  // Дебютная книга
+    EvalWeights weights;  // Веса оценки Tuned
+    bool weights_loaded = false;
+    std::vector<Searcher> searchers;  // Потоки поиска, searchers[0] - основной
+    std::unique_ptr<ThreadPool> root_pool;  // Пул для разделения ходов первого уровня в режиме NoRandom
+    size_t best_searcher = 0;  // Поток, ход которого выбран последним поиском
+    int time_limit_ms = 0;
+    bool no_random = false;
+    std::default_random_engine book_rng;  // Выбор хода из книги
+    // Обдумывание на времени соперника: поток, флаг его остановки и найденные ходы.
+    // ponder_results читаются только после остановки потока.
+    std::thread ponder_thread;
+    std::atomic<bool> ponder_stop{false};
+    std::vector<PonderResult> ponder_results;
+};
@@ -0,0 +1,178 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "Position.h"
+
+// Оценки - целые числа с точки зрения стороны, которая ходит: оценка позиции для соперника - та же с минусом.
+// INF - выигрыш (у соперника нет фигур или ходов), -INF - проигрыш.
+const int INF = 1e9;
+// Оценки позиций, где у обеих сторон есть фигуры, лежат строго между -SCORE_SCALE и SCORE_SCALE
+const int SCORE_SCALE = 1 << 24;
+
+// Оценочные функции бота. Каждая - структура со статической функцией score(pos, weights), которую поиск
+// получает параметром шаблона, так что в листьях нет ни сравнения строк, ни ветвления по настройкам.
+// Веса weights использует только настраиваемая оценка "Tuned", остальные их не читают.
+// Новая оценка добавляется новой структурой, значением ScoringType и строкой в Searcher::dispatch().
+enum class ScoringType
+{
+    NumberOnly,  // Только число фигур
+    NumberAndPotential,  // Число фигур и продвижение шашек
+    Tuned  // Признаки EvalTerm с весами из файла (см. EvalWeights)
+};
+
+// Функция scoring_from_string() переводит название оценки из settings.json ("BotScoringType")
+inline ScoringType scoring_from_string(const std::string &name)
+{
+    if (name == "NumberOnly")
+        return ScoringType::NumberOnly;
+    if (name == "NumberAndPotential")
+        return ScoringType::NumberAndPotential;
+    if (name == "Tuned")
+        return ScoringType::Tuned;
+    throw std::invalid_argument("unknown scoring type: " + name);
+}
+
+// Признаки силы стороны для оценки "Tuned"
+enum EvalTerm
+{
+    TERM_MAN,  // Число шашек
+    TERM_KING,  // Число дамок
+    TERM_ADVANCE,  // Продвижение шашек (сумма пройденных строк)
+    TERM_BACK_RANK,  // Шашки на своей первой строке (закрывают сопернику превращение)
+    TERM_CENTER,  // Шашки в центре доски (строки 3 - 4, столбцы 2 - 5)
+    EVAL_TERMS
+};
+
+inline const char *const EVAL_TERM_NAMES[EVAL_TERMS] = {"man", "king", "advance", "back_rank", "center"};
+
+// Клетки центра доски: строки 3 и 4, столбцы 2 - 5 (s = x * 4 + y / 2)
+const BB CENTER_MASK = (BB(0b0110) << 12) | (BB(0b0110) << 16);
+
+// Функция eval_terms() считает признаки обеих сторон: terms[0] - белых, terms[1] - черных
+inline void eval_terms(const Position &pos, int terms[2][EVAL_TERMS])
+{
+    for (int side = 0; side < 2; ++side)
+    {
+        const BB men = pos.men(bool(side));
+        terms[side][TERM_MAN] = pos.material[side];
+        terms[side][TERM_KING] = pos.material[2 + side];
+        terms[side][TERM_ADVANCE] = pos.advance[side];
+        terms[side][TERM_BACK_RANK] = std::popcount(men & row_mask(side ? 0 : 7));
+        terms[side][TERM_CENTER] = std::popcount(men & CENTER_MASK);
+    }
+}
+
+// Структура EvalWeights - веса признаков для оценки "Tuned". Их подбирает команда tune консольной программы
+// (см. Tools/Tuner.h). Веса по умолчанию совпадают с "NumberAndPotential" (дамка - 5 шашек,
+// строка - 0.05 шашки). Вес шашки задает масштаб: оценка зависит только от отношения весов.
+struct EvalWeights
+{
+    int w[EVAL_TERMS] = {100, 500, 5, 0, 0};
+
+    // Функция load() читает веса из текстового файла path: строки "название вес", '#' - комментарий.
+    // Не указанные в файле веса остаются прежними. Возвращает false, если файла нет или он поврежден.
+    bool load(const std::string &path)
+    {
+        std::ifstream fin(path);
+        if (!fin)
+            return false;
+        EvalWeights res = *this;
+        std::string line;
+        while (std::getline(fin, line))
+        {
+            std::istringstream ss(line.substr(0, line.find('#')));
+            std::string name;
+            int value;
+            if (!(ss >> name))
+                continue;
+            int term = 0;
+            while (term < EVAL_TERMS && name != EVAL_TERM_NAMES[term])
+                ++term;
+            if (term == EVAL_TERMS || !(ss >> value) || value < 0)
+                return false;
+            res.w[term] = value;
+        }
+        // Сила стороны, у которой остались фигуры, должна быть положительной
+        if (res.w[TERM_MAN] <= 0 || res.w[TERM_KING] <= 0)
+            return false;
+        *this = res;
+        return true;
+    }
+
+    // Функция save() записывает веса в файл path в формате load()
+    bool save(const std::string &path) const
+    {
+        std::ofstream fout(path);
+        for (int term = 0; term < EVAL_TERMS; ++term)
+            fout << EVAL_TERM_NAMES[term] << ' ' << w[term] << '\n';
+        return bool(fout);
+    }
+
+    // Функция strength() возвращает силу стороны с признаками terms
+    int strength(const int terms[EVAL_TERMS]) const
+    {
+        int s = 0;
+        for (int term = 0; term < EVAL_TERMS; ++term)
+            s += w[term] * terms[term];
+        return s;
+    }
+};
+
+// Функция ratio_score() переводит силы сторон в оценку для стороны pos.color (см. MaterialScore)
+inline int ratio_score(const Position &pos, const int w, const int b)
+{
+    const int us = pos.color ? b : w;
+    const int them = pos.color ? w : b;
+    if (them == 0)  // Если у противника нет фигур, это выигрыш
+        return INF;
+    if (us == 0)  // Если нет своих фигур, это проигрыш
+        return -INF;
+    return int(int64_t(us - them) * SCORE_SCALE / (us + them));
+}
+
+// Шаблон MaterialScore сравнивает силу сторон.
+// Сила - сумма весов фигур: шашка весит unit, дамка - unit * q_coef, и к весу шашек
+// прибавляется их продвижение (число пройденных строк), если potential.
+// Число фигур и продвижение поддерживаются в Position при каждом ходе, поэтому оценка не обходит доску.
+// Оценка - (us - them) / (us + them), умноженная на SCORE_SCALE, где us - сила стороны pos.color.
+// Она возрастает вместе с отношением сил us / them, поэтому поиск выбирает те же ходы, что и по отношению,
+// но оценка симметрична (для соперника она та же с минусом) и вычисляется в целых числах.
+// Масштаб 2^24 больше квадрата наибольшей суммы сил, так что разные отношения не сливаются при округлении.
+template <int unit, int q_coef, bool potential> struct MaterialScore
+{
+    static int score(const Position &pos, const EvalWeights &)
+    {
+        int w = unit * (pos.material[0] + q_coef * pos.material[2]);  // Сила белых
+        int b = unit * (pos.material[1] + q_coef * pos.material[3]);  // Сила черных
+        if constexpr (potential)
+        {
+            w += pos.advance[0];  // Потенциал белых шашек (близость к краю)
+            b += pos.advance[1];  // Потенциал черных шашек (близость к краю)
+        }
+        return ratio_score(pos, w, b);
+    }
+};
+
+// "NumberOnly": дамка стоит 4 шашки
+using NumberOnlyScore = MaterialScore<1, 4, false>;
+// "NumberAndPotential": дамка стоит 5 шашек, каждая пройденная шашкой строка - 0.05 шашки.
+// Чтобы считать в целых числах, все веса умножены на 20 (отношение сил от этого не меняется).
+using NumberAndPotentialScore = MaterialScore<20, 5, true>;
+
+// "Tuned": сила стороны - сумма признаков EvalTerm с весами EvalWeights, оценка - как у MaterialScore.
+// Признаки - не больше нескольких popcount, так что оценка почти не медленнее "NumberAndPotential".
+// При больших весах суммы сил могут превысить 2^12, и очень близкие отношения тогда совпадут после округления.
+struct TunedScore
+{
+    static int score(const Position &pos, const EvalWeights &weights)
+    {
+        int terms[2][EVAL_TERMS];
+        eval_terms(pos, terms);
+        return ratio_score(pos, weights.strength(terms[0]), weights.strength(terms[1]));
+    }
+};
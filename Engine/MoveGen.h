@@ -0,0 +1,255 @@
+#pragma once
+#include <bit>
+#include <cassert>
+
+#include "Position.h"
+
+// Направления ходов по диагонали:
+// 0 - вверх-влево, 1 - вверх-вправо, 2 - вниз-влево, 3 - вниз-вправо.
+// Противоположное направлению d - это 3 - d.
+// "Вверх" - к строке 0 (туда ходят белые шашки), "вниз" - к строке 7 (туда ходят черные).
+constexpr BB EVEN_ROWS = 0x0F0F0F0F;  // Строки 0, 2, 4, 6 (игровые клетки в нечетных столбцах)
+constexpr BB ODD_ROWS = 0xF0F0F0F0;  // Строки 1, 3, 5, 7 (игровые клетки в четных столбцах)
+constexpr BB LEFT_COL = 0x11111111;  // Крайние левые игровые клетки каждой строки
+constexpr BB RIGHT_COL = 0x88888888;  // Крайние правые игровые клетки каждой строки
+
+// Функция shift() сдвигает все фигуры маски b на одну клетку в направлении dir.
+// Клетки, выходящие за пределы доски, отбрасываются.
+// В четных и нечетных строках соседи по диагонали отстоят на разное число бит,
+// поэтому маска делится на две части по четности строк.
+constexpr BB shift(const BB b, const int dir)
+{
+    switch (dir)
+    {
+    case 0:
+        return ((b & EVEN_ROWS) >> 4) | ((b & ODD_ROWS & ~LEFT_COL) >> 5);
+    case 1:
+        return ((b & EVEN_ROWS & ~RIGHT_COL) >> 3) | ((b & ODD_ROWS) >> 4);
+    case 2:
+        return ((b & EVEN_ROWS) << 4) | ((b & ODD_ROWS & ~LEFT_COL) << 3);
+    default:
+        return ((b & EVEN_ROWS & ~RIGHT_COL) << 5) | ((b & ODD_ROWS) << 4);
+    }
+}
+
+// Максимальное число ходов в списке. В реальных позициях ходов заметно меньше.
+// Переполнение - ошибка: в отладочной сборке срабатывает assert, в релизной лишние ходы отбрасываются,
+// чтобы не писать за пределы массива.
+constexpr int MAX_MOVES = 128;
+
+// Структура MoveList - список ходов фиксированной емкости.
+// Создается вызывающей стороной (обычно на стеке) и не выделяет память в куче.
+struct MoveList
+{
+    Move moves[MAX_MOVES];
+    int size = 0;
+
+    void add(const uint8_t from, const uint8_t to, const BB captured = 0)
+    {
+        assert(size < MAX_MOVES);
+        if (size < MAX_MOVES)
+            moves[size++] = Move{from, to, captured, 0, 0, false};
+    }
+    void add(const Move &move)
+    {
+        assert(size < MAX_MOVES);
+        if (size < MAX_MOVES)
+            moves[size++] = move;
+    }
+    // Функция add_unique() добавляет ход, если в списке, начиная с позиции begin, нет равного ему
+    void add_unique(const Move &move, const int begin = 0)
+    {
+        for (int i = begin; i < size; ++i)
+        {
+            if (moves[i] == move)
+                return;
+        }
+        add(move);
+    }
+    void clear()
+    {
+        size = 0;
+    }
+    bool empty() const
+    {
+        return size == 0;
+    }
+    Move *begin()
+    {
+        return moves;
+    }
+    Move *end()
+    {
+        return moves + size;
+    }
+    const Move *begin() const
+    {
+        return moves;
+    }
+    const Move *end() const
+    {
+        return moves + size;
+    }
+    Move &operator[](const int i)
+    {
+        return moves[i];
+    }
+    const Move &operator[](const int i) const
+    {
+        return moves[i];
+    }
+};
+
+// Функция generate_captures() добавляет в список все взятия фигур стороны pos.color,
+// стоящих на клетках маски from. Возвращает true, если найдено хотя бы одно взятие.
+// Для шашек клетки, с которых возможно взятие, вычисляются сразу для всех фигур сдвигами масок;
+// дамка бьет на любом расстоянии и может встать на любую свободную клетку за побитой фигурой.
+inline bool generate_captures(const Position &pos, MoveList &list, const BB from = ~BB(0))
+{
+    const int begin_size = list.size;
+    const BB empty = pos.empty();
+    const BB enemy = pos.pieces[!pos.color];
+    const BB men = pos.men(pos.color) & from;
+    const BB kings = pos.queens(pos.color) & from;
+    for (int d = 0; d < 4; ++d)
+    {
+        // Шашки, за соседом которых в направлении d стоит фигура противника, а за ней пусто
+        for (BB jumpers = men & shift(shift(empty, 3 - d) & enemy, 3 - d); jumpers; jumpers &= jumpers - 1)
+        {
+            const BB bit = jumpers & (~jumpers + 1);
+            const BB beaten = shift(bit, d);
+            list.add(uint8_t(std::countr_zero(bit)), uint8_t(std::countr_zero(shift(beaten, d))), beaten);
+        }
+        for (BB rest = kings; rest; rest &= rest - 1)
+        {
+            const BB bit = rest & (~rest + 1);
+            BB b = shift(bit, d);
+            while (b & empty)
+                b = shift(b, d);
+            if (!(b & enemy))
+                continue;
+            for (BB to = shift(b, d); to & empty; to = shift(to, d))
+                list.add(uint8_t(std::countr_zero(bit)), uint8_t(std::countr_zero(to)), b);
+        }
+    }
+    return list.size != begin_size;
+}
+
+// Функция extend_capture() продолжает серию взятий m фигуры цвета color, стоящей на клетке sq.
+// enemy - оставшиеся фигуры противника, empty - пустые клетки (побитые фигуры снимаются с доски сразу).
+// Если продолжить серию нельзя, она добавляется в список; при unique - только если такой же серии
+// (с теми же началом, концом, побитыми фигурами и превращением) в списке с позиции begin еще нет.
+inline void extend_capture(const bool color, const BB enemy, const BB empty, const int sq, const bool king, const Move &m,
+                           MoveList &list, const bool unique, const int begin)
+{
+    const BB bit = BB(1) << sq;
+    bool extended = false;
+    for (int d = 0; d < 4; ++d)
+    {
+        BB b = shift(bit, d);
+        if (king)
+        {
+            while (b & empty)
+                b = shift(b, d);
+        }
+        if (!(b & enemy))
+            continue;
+        // Шашка встает сразу за побитой фигурой, дамка - на любую свободную клетку за ней
+        for (BB to = shift(b, d); to & empty; to = king ? shift(to, d) : 0)
+        {
+            extended = true;
+            const int t = std::countr_zero(to);
+            const bool promoted = !king && (to & row_mask(color ? 7 : 0));
+            Move next = m;
+            next.captured |= b;
+            next.path |= uint64_t(t) << (5 * next.length);
+            ++next.length;
+            next.to = uint8_t(t);
+            next.promotes = next.promotes || promoted;
+            extend_capture(color, enemy & ~b, (empty | b | bit) & ~to, t, king || promoted, next, list, unique, begin);
+        }
+    }
+    if (!extended && m.length)
+    {
+        if (unique)
+            list.add_unique(m, begin);
+        else
+            list.add(m);
+    }
+}
+
+// Функция generate_capture_sequences() добавляет в список все серии взятий стороны pos.color целиком,
+// каждую одним ходом. Возвращает true, если найдено хотя бы одно взятие.
+// При unique разные пути с одинаковым результатом дают один ход (поиску нет смысла перебирать их все),
+// без него - каждый путь отдельно, как при вводе хода игроком (так считает perft).
+inline bool generate_capture_sequences(const Position &pos, MoveList &list, const bool unique = true)
+{
+    const int begin_size = list.size;
+    const BB empty = pos.empty();
+    const BB enemy = pos.pieces[!pos.color];
+    // Шашки без взятия отсеиваются сразу для всех фигур сдвигами масок
+    BB jumpers = pos.queens(pos.color);
+    for (int d = 0; d < 4; ++d)
+        jumpers |= pos.men(pos.color) & shift(shift(empty, 3 - d) & enemy, 3 - d);
+    for (; jumpers; jumpers &= jumpers - 1)
+    {
+        const int s = std::countr_zero(jumpers);
+        const BB bit = BB(1) << s;
+        Move m{};
+        m.from = m.to = uint8_t(s);
+        extend_capture(pos.color, enemy, empty | bit, s, bool(pos.kings & bit), m, list, unique, begin_size);
+    }
+    return list.size != begin_size;
+}
+
+// Функция generate_quiet() добавляет в список все ходы без взятия фигур стороны pos.color с клеток маски from.
+// Шашки ходят только вперед (белые - вверх, черные - вниз), дамки - на любое расстояние.
+inline void generate_quiet(const Position &pos, MoveList &list, const BB from = ~BB(0))
+{
+    const BB empty = pos.empty();
+    const BB men = pos.men(pos.color) & from;
+    const BB kings = pos.queens(pos.color) & from;
+    const int forward = pos.color ? 2 : 0;
+    for (int d = forward; d < forward + 2; ++d)
+    {
+        for (BB movers = men & shift(empty, 3 - d); movers; movers &= movers - 1)
+        {
+            const BB bit = movers & (~movers + 1);
+            list.add(uint8_t(std::countr_zero(bit)), uint8_t(std::countr_zero(shift(bit, d))));
+        }
+    }
+    for (BB rest = kings; rest; rest &= rest - 1)
+    {
+        const BB bit = rest & (~rest + 1);
+        for (int d = 0; d < 4; ++d)
+        {
+            for (BB to = shift(bit, d); to & empty; to = shift(to, d))
+                list.add(uint8_t(std::countr_zero(bit)), uint8_t(std::countr_zero(to)));
+        }
+    }
+}
+
+// Функция generate_turns() записывает в list все допустимые ходы стороны pos.color для поиска:
+// серии взятий целиком (без повторов) или, если взятий нет, ходы без взятия.
+// Возвращает true, если найденные ходы - взятия.
+inline bool generate_turns(const Position &pos, MoveList &list, const bool unique = true)
+{
+    list.clear();
+    if (generate_capture_sequences(pos, list, unique))
+        return true;
+    generate_quiet(pos, list);
+    return false;
+}
+
+// Функция generate_moves() записывает в list все допустимые шаги стороны pos.color с клеток маски from
+// (серия взятий - по одному взятию за раз, как ее вводит игрок).
+// Так как взятие обязательно, при наличии взятий в список попадают только они.
+// Возвращает true, если найденные ходы - взятия.
+inline bool generate_moves(const Position &pos, MoveList &list, const BB from = ~BB(0))
+{
+    list.clear();
+    if (generate_captures(pos, list, from))
+        return true;
+    generate_quiet(pos, list, from);
+    return false;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+#include "MoveGen.h"
+#include "Position.h"
+
+// Функция perft_rec() считает позиции на глубине depth ходов, делая и отменяя ходы в самой позиции pos
+inline uint64_t perft_rec(Position &pos, const int depth)
+{
+    MoveList turns;
+    generate_turns(pos, turns, false);
+    // Последний ход не нужно делать
+    if (depth == 1)
+        return uint64_t(turns.size);
+    uint64_t nodes = 0;
+    for (const Move &turn : turns)
+    {
+        const Undo undo = pos.make_move(turn);
+        pos.pass_turn();
+        nodes += perft_rec(pos, depth - 1);
+        pos.pass_turn();
+        pos.unmake_move(turn, undo);
+    }
+    return nodes;
+}
+
+// Функция perft() считает число позиций на глубине depth ходов от позиции pos.
+// Ходом считается вся серия взятий, как и в поиске, но разные пути серии с одинаковым результатом
+// считаются отдельными ходами (как их может ввести игрок), поэтому числа совпадают с исходным генератором.
+// Сравнение с эталонными числами проверяет генератор ходов, а время счета - его скорость.
+inline uint64_t perft(const Position &pos, const int depth)
+{
+    if (depth == 0)
+        return 1;
+    Position copy = pos;
+    return perft_rec(copy, depth);
+}
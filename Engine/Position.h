@@ -0,0 +1,369 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Zobrist.h"
+
+// Битовая доска: бит s соответствует s-й игровой (тёмной) клетке.
+// Клетки нумеруются построчно сверху вниз, по 4 в каждой строке:
+// s = x * 4 + y / 2, где (x, y) - координаты клетки в матрице Board (x - строка, y - столбец).
+typedef uint32_t BB;
+
+// Маски строк: строка x занимает биты 4 * x ... 4 * x + 3
+constexpr BB row_mask(const int x)
+{
+    return BB(0xF) << (4 * x);
+}
+
+// Функция square_of() переводит координаты игровой клетки в номер бита
+constexpr int square_of(const POS_T x, const POS_T y)
+{
+    return x * 4 + y / 2;
+}
+// Функции square_x() и square_y() выполняют обратное преобразование номера бита в координаты
+constexpr POS_T square_x(const int s)
+{
+    return POS_T(s / 4);
+}
+constexpr POS_T square_y(const int s)
+{
+    return POS_T(2 * (s % 4) + ((s / 4) % 2 == 0));
+}
+
+// Структура Move - ход движка: перемещение фигуры с клетки from на клетку to
+// и маска captured побитых фигур (0 для хода без взятия).
+// Ход может быть целой серией взятий: тогда в path записаны клетки всех остановок по порядку
+// (по 5 бит на клетку, первая - в младших битах, последняя совпадает с to), length - число взятий.
+// Одиночный шаг серии (как его делает игрок в окне) имеет length == 0.
+// Поля не инициализируются по умолчанию, чтобы список ходов MoveList не обнулялся в каждом узле поиска:
+// пустой ход создается как Move{}.
+struct Move
+{
+    uint8_t from, to;
+    BB captured;
+    uint64_t path;
+    uint8_t length;
+    bool promotes;  // Шашка становится дамкой по ходу серии (и продолжает бить как дамка)
+
+    bool is_capture() const
+    {
+        return captured != 0;
+    }
+
+    // Функция landing() возвращает клетку i-й остановки серии взятий
+    int landing(const int i) const
+    {
+        return int(path >> (5 * i)) & 31;
+    }
+
+    // Сравниваются только начало, конец, побитые фигуры и превращение в дамку:
+    // разные пути серии с одинаковым результатом считаются одним ходом
+    bool operator==(const Move &other) const
+    {
+        return from == other.from && to == other.to && captured == other.captured && promotes == other.promotes;
+    }
+    bool operator!=(const Move &other) const
+    {
+        return !(*this == other);
+    }
+
+    // Функция to_move_pos() переводит одиночный шаг в структуру move_pos, с которой работают Board и Game
+    move_pos to_move_pos() const
+    {
+        if (!captured)
+            return move_pos(square_x(from), square_y(from), square_x(to), square_y(to));
+        const int b = std::countr_zero(captured);
+        return move_pos(square_x(from), square_y(from), square_x(to), square_y(to), square_x(b), square_y(b));
+    }
+
+    // Функция steps() переводит ход в последовательность шагов move_pos, по одному на каждое взятие серии.
+    // Побитая на шаге фигура - единственная еще не побитая фигура маски captured на диагонали
+    // между двумя остановками (уже побитые фигуры сняты с доски, и дамка может пройти через их клетки).
+    std::vector<move_pos> steps() const
+    {
+        if (length == 0)
+            return {to_move_pos()};
+        std::vector<move_pos> res;
+        BB rest = captured;
+        int sq = from;
+        for (int i = 0; i < length; ++i)
+        {
+            const int next = landing(i);
+            const POS_T x = square_x(sq), y = square_y(sq), x2 = square_x(next), y2 = square_y(next);
+            const POS_T dx = x2 > x ? 1 : -1, dy = y2 > y ? 1 : -1;
+            POS_T xb = x + dx, yb = y + dy;
+            while (!(rest & (BB(1) << square_of(xb, yb))))
+            {
+                xb += dx;
+                yb += dy;
+            }
+            rest &= ~(BB(1) << square_of(xb, yb));
+            res.emplace_back(x, y, x2, y2, xb, yb);
+            sq = next;
+        }
+        return res;
+    }
+
+    // Функция from_move_pos() выполняет обратное преобразование хода из формата move_pos
+    static Move from_move_pos(const move_pos &turn)
+    {
+        Move m{};
+        m.from = uint8_t(square_of(turn.x, turn.y));
+        m.to = uint8_t(square_of(turn.x2, turn.y2));
+        if (turn.xb != -1)
+            m.captured = BB(1) << square_of(turn.xb, turn.yb);
+        return m;
+    }
+};
+
+// Структура Undo - все, что нужно для отмены хода функцией Position::unmake_move(),
+// кроме самого хода: побитые дамки, было ли превращение в дамку, изменение хеша и прежние слагаемые оценки
+struct Undo
+{
+    BB captured_kings = 0;  // Какие из побитых фигур были дамками
+    bool promoted = false;  // Шашка стала дамкой этим ходом
+    uint64_t hash_delta = 0;  // XOR хешей до и после хода
+    int8_t material[4] = {0, 0, 0, 0};
+    int16_t advance[2] = {0, 0};
+};
+
+// Структура Position - компактное представление позиции для движка.
+// Хранит маски фигур каждого цвета (0 - белые, 1 - черные), маску дамок, очередь хода,
+// а также хеш Зобриста и слагаемые оценки (число фигур и продвижение шашек),
+// которые обновляются при каждом изменении позиции, так что оценка листа не пересчитывает доску.
+// В отличие от матрицы vector<vector<POS_T>> не требует выделений памяти и копируется за несколько инструкций.
+struct Position
+{
+    BB pieces[2] = {0, 0};  // Все фигуры белых и черных
+    BB kings = 0;  // Дамки обоих цветов
+    bool color = false;  // Чей ход: false - белые, true - черные
+    uint64_t hash = 0;  // Хеш Зобриста позиции
+    // Число фигур каждого типа (индексы как в piece_type(): белые шашки, черные шашки, белые дамки, черные дамки)
+    int8_t material[4] = {0, 0, 0, 0};
+    // Суммарное продвижение шашек каждого цвета: число строк, пройденных от своего края доски
+    int16_t advance[2] = {0, 0};
+
+    BB occupied() const
+    {
+        return pieces[0] | pieces[1];
+    }
+    BB empty() const
+    {
+        return ~occupied();
+    }
+    // Простые шашки и дамки указанного цвета
+    BB men(const bool c) const
+    {
+        return pieces[c] & ~kings;
+    }
+    BB queens(const bool c) const
+    {
+        return pieces[c] & kings;
+    }
+
+    // Функция at() возвращает фигуру в клетке (x, y) в кодировке Board:
+    // 0 - пусто, 1 - белая шашка, 2 - черная шашка, 3 - белая дамка, 4 - черная дамка
+    POS_T at(const POS_T x, const POS_T y) const
+    {
+        if ((x + y) % 2 == 0)
+            return 0;
+        const BB bit = BB(1) << square_of(x, y);
+        if (!(occupied() & bit))
+            return 0;
+        return POS_T(1 + bool(pieces[1] & bit) + 2 * bool(kings & bit));
+    }
+
+    // Функция set() ставит в клетку (x, y) фигуру type в кодировке Board (0 очищает клетку)
+    void set(const POS_T x, const POS_T y, const POS_T type)
+    {
+        const int s = square_of(x, y);
+        const BB bit = BB(1) << s;
+        if (occupied() & bit)
+            remove_piece(piece_type(bit), s);
+        pieces[0] &= ~bit;
+        pieces[1] &= ~bit;
+        kings &= ~bit;
+        if (!type)
+            return;
+        pieces[type % 2 == 0] |= bit;
+        if (type > 2)
+            kings |= bit;
+        add_piece(type - 1, s);
+    }
+
+    // Функция make_move() применяет ход m стороны color на месте (очередь хода не меняется,
+    // так как после одиночного взятия может последовать продолжение серии).
+    // Обрабатывает взятие фигуры, продвижение шашки в дамку и перемещение фигуры.
+    // Возвращает запись для отмены хода функцией unmake_move().
+    Undo make_move(const Move &m)
+    {
+        Undo undo;
+        undo.captured_kings = m.captured & kings;
+        undo.hash_delta = hash;
+        std::copy(material, material + 4, undo.material);
+        std::copy(advance, advance + 2, undo.advance);
+
+        const BB from = BB(1) << m.from;
+        const BB to = BB(1) << m.to;
+        for (BB rest = m.captured; rest; rest &= rest - 1)
+        {
+            const int s = std::countr_zero(rest);
+            remove_piece(piece_type(BB(1) << s), s);
+        }
+        pieces[!color] &= ~m.captured;  // Убираем побитую фигуру
+        kings &= ~m.captured;
+        remove_piece(piece_type(from), m.from);
+        // Перемещаем фигуру на новую позицию (дамка может закончить серию взятий на той же клетке, где начала)
+        pieces[color] = (pieces[color] & ~from) | to;
+        if (kings & from)
+            kings = (kings & ~from) | to;
+        // Превращение в дамку (белая шашка дошла до верхнего края или черная до нижнего,
+        // в том числе посреди серии взятий)
+        else if (m.promotes || (to & row_mask(color ? 7 : 0)))
+        {
+            kings |= to;
+            undo.promoted = true;
+        }
+        add_piece(piece_type(to), m.to);
+        undo.hash_delta ^= hash;
+        return undo;
+    }
+
+    // Функция unmake_move() отменяет ход m, сделанный make_move() с записью undo,
+    // возвращая позицию точно в прежнее состояние
+    void unmake_move(const Move &m, const Undo &undo)
+    {
+        const BB from = BB(1) << m.from;
+        const BB to = BB(1) << m.to;
+        const bool king = (kings & to) && !undo.promoted;
+        pieces[color] = (pieces[color] & ~to) | from;
+        kings &= ~to;
+        if (king)
+            kings |= from;
+        pieces[!color] |= m.captured;
+        kings |= undo.captured_kings;
+        hash ^= undo.hash_delta;
+        std::copy(undo.material, undo.material + 4, material);
+        std::copy(undo.advance, undo.advance + 2, advance);
+    }
+
+    // Функция pass_turn() передает ход другой стороне
+    void pass_turn()
+    {
+        color = !color;
+        hash ^= ZOBRIST.black_to_move;
+    }
+
+    // Функция start() возвращает начальную расстановку: черные шашки в строках 0 - 2, белые - в строках 5 - 7,
+    // первый ход за белыми (как в Board::make_start_mtx())
+    static Position start()
+    {
+        Position pos;
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                if (i < 3 && (i + j) % 2 == 1)
+                    pos.set(i, j, 2);
+                if (i > 4 && (i + j) % 2 == 1)
+                    pos.set(i, j, 1);
+            }
+        }
+        return pos;
+    }
+
+    // Функция from_board() строит позицию из матрицы Board::get_board()
+    static Position from_board(const std::vector<std::vector<POS_T>> &mtx, const bool color)
+    {
+        Position pos;
+        if (color)
+            pos.pass_turn();
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                if (mtx[i][j])
+                    pos.set(i, j, mtx[i][j]);
+            }
+        }
+        return pos;
+    }
+
+    // Функция to_string() записывает позицию строкой: очередь хода ('w' или 'b'), пробел
+    // и 8 строк доски сверху вниз через '/', по 4 игровые клетки в каждой:
+    // '.' - пусто, 'w'/'b' - белая/черная шашка, 'W'/'B' - белая/черная дамка.
+    // Например, начальная позиция: "w bbbb/bbbb/bbbb/..../..../wwww/wwww/wwww"
+    std::string to_string() const
+    {
+        static const char symbols[] = ".wbWB";
+        std::string res = color ? "b " : "w ";
+        for (int s = 0; s < 32; ++s)
+        {
+            if (s && s % 4 == 0)
+                res += '/';
+            res += symbols[int(at(square_x(s), square_y(s)))];
+        }
+        return res;
+    }
+
+    // Функция from_string() разбирает строку в формате to_string()
+    static Position from_string(const std::string &text)
+    {
+        static const std::string symbols = ".wbWB";
+        if (text.size() != 2 + 32 + 7 || (text[0] != 'w' && text[0] != 'b') || text[1] != ' ')
+            throw std::runtime_error("bad position string: " + text);
+        Position pos;
+        if (text[0] == 'b')
+            pos.pass_turn();
+        for (int s = 0; s < 32; ++s)
+        {
+            const size_t type = symbols.find(text[2 + s + s / 4]);
+            if (type == std::string::npos || (s % 4 == 0 && s && text[1 + s + s / 4] != '/'))
+                throw std::runtime_error("bad position string: " + text);
+            if (type)
+                pos.set(square_x(s), square_y(s), POS_T(type));
+        }
+        return pos;
+    }
+
+    // Функции add_piece() и remove_piece() учитывают появление и исчезновение фигуры type на клетке s
+    // в хеше и слагаемых оценки (сами маски фигур меняет вызывающая функция)
+    void add_piece(const int type, const int s)
+    {
+        hash ^= ZOBRIST.piece[type][s];
+        ++material[type];
+        if (type < 2)
+            advance[type] += type ? square_x(s) : 7 - square_x(s);
+    }
+    void remove_piece(const int type, const int s)
+    {
+        hash ^= ZOBRIST.piece[type][s];
+        --material[type];
+        if (type < 2)
+            advance[type] -= type ? square_x(s) : 7 - square_x(s);
+    }
+
+    // Функция piece_type() возвращает индекс фигуры на занятой клетке bit в таблицах Зобриста:
+    // 0 - белая шашка, 1 - черная шашка, 2 - белая дамка, 3 - черная дамка
+    int piece_type(const BB bit) const
+    {
+        return bool(pieces[1] & bit) + 2 * bool(kings & bit);
+    }
+
+    // Функция to_board() возвращает позицию в виде матрицы, которую использует Board
+    std::vector<std::vector<POS_T>> to_board() const
+    {
+        std::vector<std::vector<POS_T>> mtx(8, std::vector<POS_T>(8, 0));
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+                mtx[i][j] = at(i, j);
+        }
+        return mtx;
+    }
+};
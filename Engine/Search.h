@@ -0,0 +1,619 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Eval.h"
+#include "MoveGen.h"
+#include "TTable.h"
+#include "Tablebase.h"
+#include "ThreadPool.h"
+
+// Уровень оптимизации поиска ("Optimization" в settings.json)
+enum class Optimization
+{
+    O0,  // Полный минимакс без отсечений и таблицы транспозиций
+    O1,  // Альфа-бета отсечение и таблица транспозиций
+    O2  // Пока совпадает с O1
+};
+
+// Функция optimization_from_string() переводит название уровня оптимизации из settings.json
+inline Optimization optimization_from_string(const std::string &name)
+{
+    if (name == "O0")
+        return Optimization::O0;
+    if (name == "O1")
+        return Optimization::O1;
+    if (name == "O2")
+        return Optimization::O2;
+    throw std::invalid_argument("unknown optimization level: " + name);
+}
+
+// Шаблон SearchConfig - настройки поиска, известные на этапе компиляции.
+// Searcher::search() один раз выбирает нужный вариант, и дальше поиск не проверяет настройки в каждом узле.
+template <class ScoreT, Optimization opt, bool exact_depth_tt> struct SearchConfig
+{
+    using Score = ScoreT;  // Оценочная функция (см. Eval.h)
+    static constexpr bool prune = opt != Optimization::O0;  // Альфа-бета отсечение
+    static constexpr bool use_tt = opt != Optimization::O0;  // Таблица транспозиций
+    static constexpr bool deterministic = exact_depth_tt;  // Режим NoRandom (см. конструктор Searcher)
+};
+
+// Структура RootTurn - ход первого уровня вместе со всей серией взятий
+// и позиция после него (ход уже передан сопернику)
+struct RootTurn
+{
+    std::vector<move_pos> steps;
+    Position next;
+};
+
+// Структура SearchStats - счетчики поиска для измерения его скорости и качества упорядочивания ходов
+struct SearchStats
+{
+    uint64_t nodes = 0;  // Просмотренные узлы
+    uint64_t qnodes = 0;  // Из них узлы за горизонтом (см. Searcher::quiesce)
+    uint64_t tbhits = 0;  // Узлы, оценка которых взята из эндшпильных баз
+    uint64_t expanded = 0;  // Узлы, в которых перебирались ходы
+    uint64_t cutoffs = 0;  // Альфа-бета отсечения
+    uint64_t first_cutoffs = 0;  // Отсечения на первом же ходе
+
+    SearchStats &operator+=(const SearchStats &other)
+    {
+        nodes += other.nodes;
+        qnodes += other.qnodes;
+        tbhits += other.tbhits;
+        expanded += other.expanded;
+        cutoffs += other.cutoffs;
+        first_cutoffs += other.first_cutoffs;
+        return *this;
+    }
+};
+
+// Структура SearchProgress - итог очередной завершенной итерации поиска для отображения хода размышлений
+struct SearchProgress
+{
+    int depth;  // Глубина итерации
+    int score;  // Оценка лучшего хода для стороны, которая ходит
+    std::vector<move_pos> best;  // Лучший ход с серией взятий
+    uint64_t nodes;  // Узлы основного потока с начала поиска
+};
+
+// Функция, которую поиск вызывает из своего потока после каждой завершенной итерации
+using ProgressCallback = std::function<void(const SearchProgress &)>;
+
+// Класс Searcher - один поток поиска: negamax с альфа-бета отсечением, поиском с нулевым окном (PVS),
+// окном вокруг оценки прошлой итерации (aspiration window) и итеративным углублением.
+// Хранит собственные списки ходов, ходы-убийцы и таблицу истории,
+// а таблицу транспозиций и флаг остановки получает от владельца и делит с другими потоками.
+class Searcher
+{
+  public:
+    // deterministic - режим NoRandom: результат поиска не должен зависеть от порядка обхода и числа потоков,
+    // поэтому оценки из таблицы транспозиций берутся только с той же оставшейся глубины
+    // (оценка более глубокого поиска могла бы подменить значение, которое получил бы однопоточный поиск).
+    // quiescence_limit - сколько ходов за горизонтом можно продолжать обязательные взятия (см. quiesce).
+    // tablebase - эндшпильные базы (nullptr - без баз), владелец должен хранить их все время поиска.
+    // weights - веса оценки ScoringType::Tuned.
+    Searcher(const ScoringType scoring, const Optimization optimization, const unsigned seed,
+             const bool deterministic = false, const int quiescence_limit = 0,
+             const Tablebase *tablebase = nullptr, const EvalWeights &weights = EvalWeights())
+        : scoring(scoring), optimization(optimization), deterministic(deterministic),
+          quiescence_limit(quiescence_limit), tablebase(tablebase), weights(weights), rand_eng(seed)
+    {
+    }
+
+    // Функция search() ищет лучший ход (вместе со всей серией взятий) для стороны pos.color.
+    // Поиск идет итеративным углублением от глубины first_depth до max_depth: каждая итерация заполняет
+    // таблицу транспозиций, а ее лучший ход проверяется первым на следующей.
+    // Поиск прерывается, когда наступает deadline (если time_limited) или кто-то поднимает флаг stop;
+    // тогда возвращается результат последней завершенной итерации (completed_depth - ее глубина, -1 если нет).
+    // Если передан пул потоков, ходы первого уровня на каждой итерации оцениваются параллельно,
+    // задача с номером потока w выполняется объектом (*workers)[w]. Выбранный ход при этом
+    // совпадает с ходом однопоточного поиска: из ходов с лучшей оценкой берется первый по порядку.
+    std::vector<move_pos> search(const Position &pos, const int first_depth, const int max_depth, TTable &table,
+                                 std::atomic<bool> &stop, const bool time_limited,
+                                 const std::chrono::steady_clock::time_point deadline, ThreadPool *pool = nullptr,
+                                 std::vector<Searcher> *workers = nullptr)
+    {
+        std::vector<move_pos> res;
+        dispatch([&]<class Config>()
+        {
+            res = search_impl<Config>(pos, first_depth, max_depth, table, stop, time_limited, deadline, pool, workers);
+        });
+        return res;
+    }
+
+    // Функция new_game() забывает рейтинг истории, накопленный в прошлой партии
+    void new_game()
+    {
+        for (auto &side : history)
+            for (auto &from : side)
+                for (int &rating : from)
+                    rating = 0;
+    }
+
+    int completed_depth = -1;  // Глубина последней завершенной итерации
+    // Оценка выбранного хода в последней завершенной итерации для стороны, которая ходит
+    // (0, если поиск не понадобился: ход единственный)
+    int root_score = 0;
+    SearchStats stats;  // Накапливаются между поисками, обнуляет владелец
+    const ProgressCallback *progress = nullptr;  // Вызывается после каждой итерации (nullptr - не вызывается)
+
+  private:
+    // Функция dispatch() вызывает f.operator()<Config>() с вариантом SearchConfig для настроек этого объекта.
+    // Это единственное место, где настройки проверяются во время работы; новая оценочная функция
+    // добавляется сюда новой строкой в switch.
+    template <class F> void dispatch(F &&f) const
+    {
+        const auto with_score = [&]<class Score>()
+        {
+            // O2 пока не отличается от O1, поэтому отдельный вариант поиска для него не создается
+            if (optimization == Optimization::O0)
+                deterministic ? f.template operator()<SearchConfig<Score, Optimization::O0, true>>()
+                              : f.template operator()<SearchConfig<Score, Optimization::O0, false>>();
+            else
+                deterministic ? f.template operator()<SearchConfig<Score, Optimization::O1, true>>()
+                              : f.template operator()<SearchConfig<Score, Optimization::O1, false>>();
+        };
+        switch (scoring)
+        {
+        case ScoringType::NumberOnly:
+            with_score.template operator()<NumberOnlyScore>();
+            break;
+        case ScoringType::NumberAndPotential:
+            with_score.template operator()<NumberAndPotentialScore>();
+            break;
+        case ScoringType::Tuned:
+            with_score.template operator()<TunedScore>();
+            break;
+        }
+    }
+
+    template <class Config>
+    std::vector<move_pos> search_impl(const Position &pos, const int first_depth, const int max_depth,
+                                      TTable &table, std::atomic<bool> &stop, const bool time_limited,
+                                      const std::chrono::steady_clock::time_point deadline, ThreadPool *pool,
+                                      std::vector<Searcher> *workers)
+    {
+        tt = &table;
+        stop_flag = &stop;
+        this->time_limited = time_limited;
+        this->deadline = deadline;
+        // Ходы-убийцы относятся к прошлой позиции, а рейтинг истории постепенно забывается
+        for (auto &ply_killers : killers)
+            ply_killers[0] = ply_killers[1] = Move();
+        for (auto &side : history)
+            for (auto &from : side)
+                for (int &rating : from)
+                    rating /= 2;
+
+        const auto start = std::chrono::steady_clock::now();
+        completed_depth = -1;
+        root_score = 0;
+        stop_search = false;
+
+        // Все ходы первого уровня перечисляются один раз на весь поиск
+        std::vector<RootTurn> root = collect_root_turns(pos);
+        if (root.size() <= 1)
+        {
+            // Единственный ход не требует поиска
+            completed_depth = max_depth;
+            return root.empty() ? std::vector<move_pos>() : root[0].steps;
+        }
+
+        std::vector<move_pos> res;
+        for (search_depth = first_depth; search_depth <= max_depth; ++search_depth)
+        {
+            const int best = pool ? search_root_parallel<Config>(root, *pool, *workers, root_score)
+                                  : search_root_aspiration<Config>(root, root_score);
+            if (best == -1)
+                break;
+
+            res = root[best].steps;
+            completed_depth = search_depth;
+            if (progress && *progress)
+                (*progress)(SearchProgress{search_depth, root_score, res, stats.nodes});
+            // Лучший ход итерации переносим в начало, не меняя порядок остальных
+            std::rotate(root.begin(), root.begin() + best, root.begin() + best + 1);
+
+            // Следующая итерация обычно в несколько раз дольше текущей, поэтому не начинаем ее,
+            // если израсходована уже половина времени
+            if (time_limited && std::chrono::steady_clock::now() - start > (deadline - start) / 2)
+                break;
+        }
+        return res;
+    }
+
+    // Структура Iteration - настройки текущей итерации, которые задачи пула копируют себе.
+    // Копия снимается до запуска задач: поток 0 пула - сам основной объект, и его поля меняются во время работы.
+    struct Iteration
+    {
+        TTable *tt;
+        std::atomic<bool> *stop_flag;
+        bool time_limited;
+        std::chrono::steady_clock::time_point deadline;
+        int search_depth;
+    };
+
+    // Функция search_root_turn() оценивает один ход первого уровня в задаче пула потоков
+    template <class Config> int search_root_turn(const RootTurn &turn, const Iteration &it)
+    {
+        tt = it.tt;
+        stop_flag = it.stop_flag;
+        time_limited = it.time_limited;
+        deadline = it.deadline;
+        search_depth = it.search_depth;
+        stop_search = false;
+        Position pos = turn.next;
+        return -find_best_turns_rec<Config>(pos, 0, -INF - 1, INF + 1);
+    }
+
+    // Функция order_turns() упорядочивает ходы для альфа-бета отсечения:
+    // сначала ход из таблицы транспозиций, затем взятия (больше побитых фигур - раньше, при равенстве
+    // раньше серия со взятием дамки),
+    // затем два хода-убийцы этой глубины, остальные - по убыванию рейтинга в таблице истории.
+    void order_turns(MoveList &turns, const Position &pos, const Move &hash_move, const size_t depth) const
+    {
+        int keys[MAX_MOVES];
+        for (int i = 0; i < turns.size; ++i)
+        {
+            const Move &turn = turns[i];
+            if (turn == hash_move)
+                keys[i] = 1 << 30;
+            else if (turn.is_capture())
+                keys[i] = (1 << 29) + 2 * std::popcount(turn.captured) + bool(turn.captured & pos.kings);
+            else if (depth < MAX_PLY && turn == killers[depth][0])
+                keys[i] = (1 << 28) + 1;
+            else if (depth < MAX_PLY && turn == killers[depth][1])
+                keys[i] = 1 << 28;
+            else
+                keys[i] = std::min(history[pos.color][turn.from][turn.to], (1 << 28) - 1);
+        }
+        // Сортировка вставками: ходов немного, и она устойчива
+        for (int i = 1; i < turns.size; ++i)
+        {
+            const Move turn = turns[i];
+            const int key = keys[i];
+            int j = i;
+            for (; j > 0 && keys[j - 1] < key; --j)
+            {
+                turns[j] = turns[j - 1];
+                keys[j] = keys[j - 1];
+            }
+            turns[j] = turn;
+            keys[j] = key;
+        }
+    }
+
+    // Функция time_is_up() проверяет, не пора ли прервать поиск: истек лимит времени на ход
+    // или кто-то поднял общий флаг остановки. Часы опрашиваются раз в 1024 узла.
+    // Первая итерация (глубина 0) не прерывается по времени, чтобы у бота всегда был ход,
+    // но внешняя остановка (отмена поиска владельцем) действует и на ней.
+    bool time_is_up()
+    {
+        ++stats.nodes;
+        if (stop_search)
+            return true;
+        if (time_limited && search_depth > 0 && (stats.nodes & 1023) == 0 &&
+            std::chrono::steady_clock::now() >= deadline)
+            stop_flag->store(true, std::memory_order_relaxed);
+        stop_search = stop_flag->load(std::memory_order_relaxed);
+        return stop_search;
+    }
+
+    // Функция collect_root_turns() перечисляет ходы первого уровня (серия взятий - один ход).
+    // Случайность остается только здесь: ходы перемешиваются (при NoRandom - всегда одинаково),
+    // поэтому среди равных по оценке ходов бот выбирает случайный. Взятия дамок проверяются первыми.
+    std::vector<RootTurn> collect_root_turns(Position pos)
+    {
+        MoveList turns_now;
+        generate_turns(pos, turns_now);
+        std::shuffle(turns_now.begin(), turns_now.end(), rand_eng);
+        std::stable_partition(turns_now.begin(), turns_now.end(),
+                              [&](const Move &turn) { return bool(turn.captured & pos.kings); });
+
+        std::vector<RootTurn> res;
+        for (const Move &turn : turns_now)
+        {
+            const Undo undo = pos.make_move(turn);
+            res.push_back(RootTurn{turn.steps(), pos});
+            res.back().next.pass_turn();
+            pos.unmake_move(turn, undo);
+        }
+        return res;
+    }
+
+    // Функция search_root_aspiration() оценивает ходы первого уровня в окне шириной ASPIRATION_WINDOW
+    // вокруг оценки score прошлой итерации: лучший ход обычно меняет оценку мало, а узкое окно отсекает
+    // больше ветвей. Если лучшая оценка вышла за окно, она неточная, и поиск повторяется с окном,
+    // расширенным в эту сторону в 4 раза (когда окно шире SCORE_SCALE - до конца).
+    // На первой итерации, после найденного выигрыша или проигрыша и без отсечений окно полное.
+    // Возвращает индекс лучшего хода (score - его оценка) или -1, если поиск прерван.
+    template <class Config> int search_root_aspiration(const std::vector<RootTurn> &root, int &score)
+    {
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -INF - 1, beta = INF + 1;
+        if (Config::prune && completed_depth >= 0 && std::abs(score) < SCORE_SCALE)
+        {
+            alpha = score - delta;
+            beta = score + delta;
+        }
+        while (true)
+        {
+            int best_score = 0;
+            const int best = search_root<Config>(root, alpha, beta, best_score);
+            if (best == -1)
+                return -1;
+            delta *= 4;
+            if (best_score <= alpha && alpha > -INF - 1)
+                alpha = delta < SCORE_SCALE ? score - delta : -INF - 1;
+            else if (best_score >= beta && beta < INF + 1)
+                beta = delta < SCORE_SCALE ? score + delta : INF + 1;
+            else
+            {
+                score = best_score;
+                return best;
+            }
+        }
+    }
+
+    // Функция search_root() оценивает ходы первого уровня по порядку в окне (alpha, beta):
+    // первый ход - с полным окном, остальные - с нулевым окном от лучшей найденной оценки (см. find_best_turns_rec).
+    // Из ходов с равной оценкой выбирается первый. Возвращает индекс лучшего хода (best_score - его оценка
+    // или граница, если она вне окна) или -1, если поиск прерван.
+    template <class Config>
+    int search_root(const std::vector<RootTurn> &root, int alpha, const int beta, int &best_score)
+    {
+        best_score = -INF - 1;
+        int best = -1;
+        for (size_t i = 0; i < root.size(); ++i)
+        {
+            Position pos = root[i].next;
+            int score;
+            if (!Config::prune || i == 0)
+                score = -find_best_turns_rec<Config>(pos, 0, -beta, -alpha);
+            else
+            {
+                score = -find_best_turns_rec<Config>(pos, 0, -alpha - 1, -alpha);
+                if (score > alpha && score < beta)
+                    score = -find_best_turns_rec<Config>(pos, 0, -beta, -alpha);
+            }
+            if (stop_search)
+                return -1;
+            // Обновление наилучшего хода
+            if (score > best_score)
+            {
+                best_score = score;
+                best = int(i);
+            }
+            if (Config::prune)
+            {
+                alpha = std::max(alpha, score);
+                if (alpha >= beta)
+                    break;
+            }
+        }
+        return best;
+    }
+
+    // Функция search_root_parallel() оценивает все ходы первого уровня в пуле потоков с полным окном,
+    // получая точные оценки, и выбирает первый по порядку ход с наибольшей оценкой (score) -
+    // тот же, который выбрал бы search_root(). Возвращает -1, если поиск прерван.
+    template <class Config>
+    int search_root_parallel(const std::vector<RootTurn> &root, ThreadPool &pool, std::vector<Searcher> &workers,
+                             int &score)
+    {
+        std::vector<int> scores(root.size());
+        const Iteration it{tt, stop_flag, time_limited, deadline, search_depth};
+        // Поток 0 пула - текущий, поэтому workers[0] может быть этим же объектом
+        pool.run(int(root.size()), [&](const int i, const unsigned worker)
+        {
+            scores[i] = workers[worker].search_root_turn<Config>(root[i], it);
+        });
+        search_depth = it.search_depth;
+        if (stop_flag->load())
+            return -1;
+        int best = 0;
+        for (size_t i = 1; i < root.size(); ++i)
+        {
+            if (scores[i] > scores[best])
+                best = int(i);
+        }
+        score = scores[best];
+        return best;
+    }
+
+    // Функция quiesce() оценивает позицию на горизонте и за ним. Если у стороны, которая ходит, есть взятие,
+    // позиция не спокойная: оценка посреди размена ошибается на целую фигуру. Тогда поиск продолжается
+    // по сериям взятий, пропустить которые нельзя (взятие обязательно, поэтому и оценки "без хода" здесь нет).
+    // Если взятий нет, позиция оценивается как есть. Не более quiescence_limit ходов за горизонтом.
+    template <class Config> int quiesce(Position &pos, const size_t depth, int alpha, const int beta)
+    {
+        MoveList captures;
+        if (int(depth) - search_depth >= quiescence_limit || !generate_capture_sequences(pos, captures))
+            return Config::Score::score(pos, weights);
+        order_turns(captures, pos, Move{}, depth);
+        ++stats.expanded;
+
+        int best_score = -INF - 1;
+        for (const Move &turn : captures)
+        {
+            const Undo undo = pos.make_move(turn);
+            pos.pass_turn();
+            ++stats.qnodes;
+            const int score = -find_best_turns_rec<Config>(pos, depth + 1, -beta, -alpha);
+            pos.pass_turn();
+            pos.unmake_move(turn, undo);
+            if (stop_search)
+                return 0;
+
+            best_score = std::max(best_score, score);
+            if (Config::prune)
+            {
+                alpha = std::max(alpha, score);
+                if (alpha >= beta)
+                {
+                    ++stats.cutoffs;
+                    stats.first_cutoffs += (&turn == captures.begin());
+                    break;
+                }
+            }
+        }
+        return best_score;
+    }
+
+    // Рекурсивная функция negamax с альфа-бета отсечением.
+    // Возвращает оценку позиции pos для стороны pos.color: точную, если она внутри окна (alpha, beta),
+    // иначе только границу (не больше alpha или не меньше beta).
+    // Первый после упорядочивания ход ищется с полным окном, остальные - с нулевым окном (alpha, alpha + 1),
+    // которое лишь проверяет, не лучше ли ход уже найденного; только такие ходы ищутся заново с полным окном
+    // (principal variation search).
+    // Ходы делаются и отменяются в самой позиции pos, к возврату из функции она восстанавливается.
+    // На горизонте поиск продолжается только по взятиям (см. quiesce), спокойные листья оцениваются
+    // функцией Config::Score::score() (см. Eval.h).
+    template <class Config>
+    int find_best_turns_rec(Position &pos, const size_t depth, int alpha, const int beta)
+    {
+        // Проверка на достижение максимальной глубины
+        if (time_is_up())
+            return 0;
+        // Позиции из эндшпильных баз не ищутся: их результат известен точно (ничья - 0, см. tb_score)
+        if (tablebase && std::popcount(pos.occupied()) <= tablebase->max_pieces())
+        {
+            int score;
+            if (tablebase->probe(pos, score))
+            {
+                ++stats.tbhits;
+                return score;
+            }
+        }
+        if (depth >= size_t(search_depth))
+        {
+            return quiesce<Config>(pos, depth, alpha, beta);
+        }
+
+        // Проверка таблицы транспозиций
+        const uint64_t key = pos.hash;
+        const int remaining = int(search_depth - depth);
+        const int alpha_orig = alpha;
+        Move hash_move{};
+        TTEntry entry;
+        if (Config::use_tt && tt->probe(key, entry))
+        {
+            if (Config::deterministic ? entry.depth == remaining : entry.depth >= remaining)
+            {
+                if (entry.bound == Bound::EXACT ||
+                    (entry.bound == Bound::LOWER && entry.score >= beta) ||
+                    (entry.bound == Bound::UPPER && entry.score <= alpha))
+                    return entry.score;
+            }
+            hash_move = entry.move;
+        }
+
+        // Определение возможных ходов (серия взятий - один ход)
+        MoveList turns_now;
+        generate_turns(pos, turns_now);
+
+        // Если нет возможных ходов, это проигрыш
+        if (turns_now.empty())
+            return -INF;
+        order_turns(turns_now, pos, hash_move, depth);
+        ++stats.expanded;
+
+        int best_score = -INF - 1;
+        Move best_move{};
+
+        for (const Move &turn : turns_now)
+        {
+            // Рекурсивный вызов для хода противника
+            const Undo undo = pos.make_move(turn);
+            pos.pass_turn();
+            int score;
+            if (!Config::prune || &turn == turns_now.begin())
+                score = -find_best_turns_rec<Config>(pos, depth + 1, -beta, -alpha);
+            else
+            {
+                score = -find_best_turns_rec<Config>(pos, depth + 1, -alpha - 1, -alpha);
+                if (score > alpha && score < beta)
+                    score = -find_best_turns_rec<Config>(pos, depth + 1, -beta, -alpha);
+            }
+            pos.pass_turn();
+            pos.unmake_move(turn, undo);
+            if (stop_search)
+                return 0;  // Результат прерванного поиска не используется и не сохраняется
+
+            if (score > best_score)
+            {
+                best_score = score;
+                best_move = turn;
+            }
+
+            // Альфа-бета отсечение
+            if (Config::prune)
+            {
+                alpha = std::max(alpha, score);
+                if (alpha >= beta)
+                {
+                    ++stats.cutoffs;
+                    stats.first_cutoffs += (&turn == turns_now.begin());
+                    // Тихий ход, вызвавший отсечение, запоминаем как ход-убийцу и повышаем его рейтинг в истории
+                    if (!turn.is_capture())
+                    {
+                        if (depth < MAX_PLY && killers[depth][0] != turn)
+                        {
+                            killers[depth][1] = killers[depth][0];
+                            killers[depth][0] = turn;
+                        }
+                        history[pos.color][turn.from][turn.to] += remaining * remaining;
+                    }
+                    break;
+                }
+            }
+        }
+
+        // Сохраняем найденную оценку или границу без сдвигов, чтобы ее можно было использовать с другим окном
+        if (Config::use_tt)
+        {
+            Bound bound = Bound::EXACT;
+            if (best_score <= alpha_orig)
+                bound = Bound::UPPER;
+            else if (best_score >= beta)
+                bound = Bound::LOWER;
+            tt->store(key, remaining, best_score, bound, best_move);
+        }
+        return best_score;
+    }
+
+    ScoringType scoring;
+    Optimization optimization;
+    bool deterministic;
+    int quiescence_limit;
+    const Tablebase *tablebase;
+    EvalWeights weights;
+    std::default_random_engine rand_eng;
+
+    // Общие для всех потоков таблица транспозиций и флаг остановки
+    TTable *tt = nullptr;
+    std::atomic<bool> *stop_flag = nullptr;
+
+    // Итеративное углубление и контроль времени
+    int search_depth = 0;  // Глубина текущей итерации
+    bool time_limited = false;
+    std::chrono::steady_clock::time_point deadline;
+    bool stop_search = false;
+    // Половина ширины окна вокруг оценки прошлой итерации, примерно 0.1 шашки в начале партии
+    static const int ASPIRATION_WINDOW = SCORE_SCALE / 256;
+
+    // Упорядочивание ходов: ходы-убийцы по глубине и таблица истории [цвет][откуда][куда]
+    static const int MAX_PLY = 64;
+    Move killers[MAX_PLY][2] = {};
+    int history[2][32][32] = {};
+};
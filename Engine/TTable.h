@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "Position.h"
+
+// Тип оценки, сохраненной в таблице транспозиций
+enum class Bound : uint8_t
+{
+    NONE,  // Пустая запись
+    EXACT,  // Точное значение
+    LOWER,  // Нижняя граница (было отсечение по beta)
+    UPPER  // Верхняя граница (ни один ход не улучшил alpha)
+};
+
+// Запись таблицы транспозиций в распакованном виде
+struct TTEntry
+{
+    int score = 0;  // Оценка позиции с точки зрения стороны, которая ходит
+    Move move{};  // Лучший найденный ход (сохраняются from, to, captured и promotes - все, что сравнивает ==)
+    int8_t depth = -1;  // Оставшаяся глубина поиска, на которой получена оценка
+    Bound bound = Bound::NONE;
+    uint8_t age = 0;  // Номер поиска, в котором сделана запись
+};
+
+// Класс TTable - таблица транспозиций фиксированного размера, общая для всех потоков поиска.
+// Число корзин - степень двойки, индекс корзины берется из младших бит хеша.
+// В корзине две записи: первая заменяется только более глубоким (или устаревшим) результатом,
+// вторая перезаписывается всегда, поэтому свежие позиции тоже попадают в таблицу.
+// Блокировок нет: запись хранит хеш, сложенный по XOR с данными, и если два потока
+// записали ее одновременно, проверка ключа при чтении не пройдет и запись будет проигнорирована.
+class TTable
+{
+  public:
+    TTable() = default;
+    explicit TTable(const size_t size_mb)
+    {
+        resize(size_mb);
+    }
+
+    // Функция resize() выделяет таблицу размером не более size_mb мегабайт и очищает ее
+    void resize(const size_t size_mb)
+    {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= size_mb * 1024 * 1024)
+            count *= 2;
+        buckets = std::vector<Bucket>(count);
+        mask = count - 1;
+        age = 0;
+    }
+
+    // Функция clear() удаляет все записи
+    void clear()
+    {
+        for (Bucket &bucket : buckets)
+        {
+            for (Slot &slot : bucket.slots)
+            {
+                slot.check.store(0, std::memory_order_relaxed);
+                slot.score.store(0, std::memory_order_relaxed);
+                slot.meta.store(0, std::memory_order_relaxed);
+            }
+        }
+        age = 0;
+    }
+
+    // Функция new_search() вызывается перед каждым новым поиском:
+    // записи прошлых поисков становятся кандидатами на замену в первую очередь
+    void new_search()
+    {
+        ++age;
+    }
+
+    // Функция probe() ищет запись для позиции с хешем key и копирует ее в entry.
+    // Возвращает false, если записи нет.
+    bool probe(const uint64_t key, TTEntry &entry) const
+    {
+        const Bucket &bucket = buckets[key & mask];
+        for (const Slot &slot : bucket.slots)
+        {
+            const uint64_t score = slot.score.load(std::memory_order_relaxed);
+            const uint64_t meta = slot.meta.load(std::memory_order_relaxed);
+            if (meta == 0 || (slot.check.load(std::memory_order_relaxed) ^ score ^ meta) != key)
+                continue;
+            entry = unpack(meta);
+            entry.score = int(int32_t(uint32_t(score)));
+            entry.move.captured = BB(score >> 32);
+            return true;
+        }
+        return false;
+    }
+
+    // Функция store() сохраняет результат поиска позиции с хешем key
+    void store(const uint64_t key, const int depth, const int score, const Bound bound, const Move &move)
+    {
+        Bucket &bucket = buckets[key & mask];
+        Slot &deep = bucket.slots[0];
+        Slot *slot = &bucket.slots[1];
+        const uint64_t deep_meta = deep.meta.load(std::memory_order_relaxed);
+        const TTEntry old = unpack(deep_meta);
+        if (deep_meta == 0 || old.age != age || depth >= old.depth ||
+            (deep.check.load(std::memory_order_relaxed) ^ deep.score.load(std::memory_order_relaxed) ^ deep_meta) == key)
+            slot = &deep;
+
+        // Побитые фигуры хода хранятся в старшей половине слова оценки: с одинаковыми from и to
+        // могут быть разные серии взятий, и без маски лучший ход нельзя было бы отличить от них
+        const uint64_t score_bits = uint64_t(uint32_t(score)) | uint64_t(move.captured) << 32;
+        const uint64_t meta = uint64_t(move.from) | uint64_t(move.to) << 8 | uint64_t(uint8_t(depth)) << 16 |
+                              uint64_t(bound) << 24 | uint64_t(age) << 32 | uint64_t(move.promotes) << 40;
+        slot->check.store(key ^ score_bits ^ meta, std::memory_order_relaxed);
+        slot->score.store(score_bits, std::memory_order_relaxed);
+        slot->meta.store(meta, std::memory_order_relaxed);
+    }
+
+  private:
+    // Упакованная запись: check = key ^ score ^ meta
+    struct Slot
+    {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> score{0};  // Оценка и побитые фигуры хода
+        std::atomic<uint64_t> meta{0};  // from, to, depth, bound, age, promotes (0 - пустая запись)
+    };
+    struct Bucket
+    {
+        Slot slots[2];
+    };
+
+    static TTEntry unpack(const uint64_t meta)
+    {
+        TTEntry entry;
+        entry.move.from = uint8_t(meta);
+        entry.move.to = uint8_t(meta >> 8);
+        entry.depth = int8_t(meta >> 16);
+        entry.bound = Bound(uint8_t(meta >> 24));
+        entry.age = uint8_t(meta >> 32);
+        entry.move.promotes = (meta >> 40) & 1;
+        return entry;
+    }
+
+    std::vector<Bucket> buckets = std::vector<Bucket>(1);
+    size_t mask = 0;
+    uint8_t age = 0;
+};
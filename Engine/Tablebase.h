@@ -0,0 +1,303 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Eval.h"
+#include "MappedFile.h"
+#include "Position.h"
+
+// Эндшпильные базы: для каждой позиции с небольшим числом фигур записан ее точный результат -
+// выигрыш, проигрыш или ничья для стороны, которая ходит, и число ходов до конца партии
+// (ход - вся серия взятий, как в поиске). Базы строит команда tbgen консольной программы
+// (см. Tools/TablebaseGen.h), а движок отображает файл в память и берет оттуда оценки без поиска.
+//
+// Позиции хранятся с точки зрения стороны, которая ходит: если ходят черные, доска поворачивается
+// на 180 градусов и цвета меняются местами, так что в файле ходят всегда белые и позиций вдвое меньше.
+// Для каждого соотношения фигур (шашки и дамки своих и чужих) своя таблица по байту на позицию.
+// Номер позиции в таблице составляется из номеров сочетаний клеток каждой группы фигур
+// (свои шашки - на клетках 4 - 31, чужие шашки - 0 - 27, дамки - на любой из 32 клеток).
+// Сочетания, где фигуры разных групп стоят на одной клетке, не используются: так проще вычислять номер.
+// Значение байта: 0 - ничья, d + 1 - конец партии через d ходов (при четном d сторона проигрывает,
+// при нечетном - выигрывает), TB_INVALID - невозможная расстановка.
+//
+// Формат файла (числа - little-endian): заголовок TBFileHeader, table_count записей TBFileEntry,
+// затем таблицы, каждая с начала, кратного 8 байтам.
+
+const int TB_MAX_PIECES = 8;  // Наибольшее число фигур, которое поддерживает формат
+const uint8_t TB_INVALID = 255;
+const int TB_MAX_DISTANCE = TB_INVALID - 2;
+// Оценка выигрыша из базы: TB_WIN - d. Она больше любой оценки материала,
+// но меньше INF, поэтому выигрыш, найденный самим поиском, остается лучше.
+const int TB_WIN = INF / 2;
+const char TB_MAGIC[8] = {'C', 'K', 'R', 'S', 'T', 'B', '0', '1'};
+const uint32_t TB_VERSION = 1;
+
+struct TBFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t max_pieces;  // Базы построены для всех позиций не более чем с max_pieces фигурами
+    uint32_t table_count;
+    uint32_t reserved;
+};
+
+struct TBFileEntry
+{
+    uint8_t men[2];  // Число шашек стороны, которая ходит, и соперника
+    uint8_t kings[2];  // Число дамок стороны, которая ходит, и соперника
+    uint32_t reserved;
+    uint64_t offset;  // Начало таблицы от начала файла
+    uint64_t size;  // Число позиций (байт) в таблице
+};
+
+// Таблица биномиальных коэффициентов C(n, k) для нумерации сочетаний клеток
+struct TBBinomials
+{
+    uint64_t c[33][TB_MAX_PIECES + 1] = {};
+
+    constexpr TBBinomials()
+    {
+        for (int n = 0; n <= 32; ++n)
+        {
+            c[n][0] = 1;
+            for (int k = 1; k <= TB_MAX_PIECES && k <= n; ++k)
+                c[n][k] = c[n - 1][k - 1] + (k < n ? c[n - 1][k] : 0);
+        }
+    }
+};
+
+inline constexpr TBBinomials TB_BINOMIAL{};
+
+// Функция tb_rank() возвращает номер сочетания клеток mask среди всех сочетаний из стольких же клеток
+// (сумма C(p_i, i) по клеткам p_1 < p_2 < ... маски)
+inline uint64_t tb_rank(BB mask)
+{
+    uint64_t r = 0;
+    for (int i = 1; mask; ++i, mask &= mask - 1)
+        r += TB_BINOMIAL.c[std::countr_zero(mask)][i];
+    return r;
+}
+
+// Функция tb_unrank() выполняет обратное преобразование: сочетание из k клеток с номером r
+inline BB tb_unrank(uint64_t r, const int k)
+{
+    BB mask = 0;
+    for (int i = k; i > 0; --i)
+    {
+        int p = i - 1;
+        while (p < 31 && TB_BINOMIAL.c[p + 1][i] <= r)
+            ++p;
+        mask |= BB(1) << p;
+        r -= TB_BINOMIAL.c[p][i];
+    }
+    return mask;
+}
+
+// Функция tb_flip() поворачивает маску клеток на 180 градусов: клетка s переходит в 31 - s
+inline BB tb_flip(BB b)
+{
+    b = ((b >> 1) & 0x55555555) | ((b & 0x55555555) << 1);
+    b = ((b >> 2) & 0x33333333) | ((b & 0x33333333) << 2);
+    b = ((b >> 4) & 0x0F0F0F0F) | ((b & 0x0F0F0F0F) << 4);
+    b = ((b >> 8) & 0x00FF00FF) | ((b & 0x00FF00FF) << 8);
+    return (b >> 16) | (b << 16);
+}
+
+// Структура TBMaterial - соотношение фигур, для которого строится одна таблица
+// (индекс 0 - сторона, которая ходит, 1 - соперник)
+struct TBMaterial
+{
+    int men[2] = {0, 0};
+    int kings[2] = {0, 0};
+
+    int pieces() const
+    {
+        return men[0] + men[1] + kings[0] + kings[1];
+    }
+
+    // Функция size() возвращает число позиций в таблице
+    uint64_t size() const
+    {
+        return TB_BINOMIAL.c[28][men[0]] * TB_BINOMIAL.c[28][men[1]] * TB_BINOMIAL.c[32][kings[0]] *
+               TB_BINOMIAL.c[32][kings[1]];
+    }
+
+    // Функция slot() возвращает место таблицы в каталоге Tablebase
+    size_t slot() const
+    {
+        const int n = TB_MAX_PIECES + 1;
+        return size_t(((men[0] * n + men[1]) * n + kings[0]) * n + kings[1]);
+    }
+};
+
+// Структура TBKey - позиция с точки зрения стороны, которая ходит: ее фигуры играют за белых
+struct TBKey
+{
+    BB men[2] = {0, 0};
+    BB kings[2] = {0, 0};
+
+    static TBKey of(const Position &pos)
+    {
+        TBKey key;
+        for (int side = 0; side < 2; ++side)
+        {
+            const bool c = pos.color != bool(side);
+            key.men[side] = pos.color ? tb_flip(pos.men(c)) : pos.men(c);
+            key.kings[side] = pos.color ? tb_flip(pos.queens(c)) : pos.queens(c);
+        }
+        return key;
+    }
+
+    // Функция position() строит позицию с этой расстановкой и ходом белых
+    Position position() const
+    {
+        Position pos;
+        for (int side = 0; side < 2; ++side)
+        {
+            for (BB b = men[side]; b; b &= b - 1)
+            {
+                const int s = std::countr_zero(b);
+                pos.set(square_x(s), square_y(s), POS_T(1 + side));
+            }
+            for (BB b = kings[side]; b; b &= b - 1)
+            {
+                const int s = std::countr_zero(b);
+                pos.set(square_x(s), square_y(s), POS_T(3 + side));
+            }
+        }
+        return pos;
+    }
+
+    TBMaterial material() const
+    {
+        TBMaterial m;
+        for (int side = 0; side < 2; ++side)
+        {
+            m.men[side] = std::popcount(men[side]);
+            m.kings[side] = std::popcount(kings[side]);
+        }
+        return m;
+    }
+
+    // Функция valid() проверяет, что у обеих сторон есть фигуры, их не больше, чем поддерживает формат,
+    // а шашки не стоят на последней для себя строке (там они уже стали бы дамками)
+    bool valid() const
+    {
+        const BB us = men[0] | kings[0], them = men[1] | kings[1];
+        return us && them && std::popcount(us | them) <= TB_MAX_PIECES && !(men[0] & row_mask(0)) &&
+               !(men[1] & row_mask(7));
+    }
+
+    // Функция index() возвращает номер позиции в таблице ее соотношения фигур
+    uint64_t index() const
+    {
+        const TBMaterial m = material();
+        uint64_t index = tb_rank(men[0] >> 4);
+        index = index * TB_BINOMIAL.c[28][m.men[1]] + tb_rank(men[1]);
+        index = index * TB_BINOMIAL.c[32][m.kings[0]] + tb_rank(kings[0]);
+        return index * TB_BINOMIAL.c[32][m.kings[1]] + tb_rank(kings[1]);
+    }
+
+    // Функция from_index() выполняет обратное преобразование. Расстановка может оказаться невозможной
+    // (фигуры на одной клетке) - это проверяет вызывающая сторона.
+    static TBKey from_index(const TBMaterial &m, uint64_t index)
+    {
+        TBKey key;
+        const uint64_t k1 = TB_BINOMIAL.c[32][m.kings[1]], k0 = TB_BINOMIAL.c[32][m.kings[0]],
+                       m1 = TB_BINOMIAL.c[28][m.men[1]];
+        key.kings[1] = tb_unrank(index % k1, m.kings[1]);
+        index /= k1;
+        key.kings[0] = tb_unrank(index % k0, m.kings[0]);
+        index /= k0;
+        key.men[1] = tb_unrank(index % m1, m.men[1]);
+        key.men[0] = tb_unrank(index / m1, m.men[0]) << 4;
+        return key;
+    }
+};
+
+// Функция tb_score() переводит значение из таблицы в оценку поиска: TB_WIN - d при выигрыше через d ходов,
+// -(TB_WIN - d) при проигрыше, 0 при ничьей. Чем ближе выигрыш, тем выше оценка, поэтому бот
+// доводит выигранный эндшпиль до конца, а не ходит по кругу до ничьей по числу ходов.
+inline int tb_score(const uint8_t value)
+{
+    if (value == 0 || value == TB_INVALID)
+        return 0;
+    const int d = value - 1;
+    return d % 2 ? TB_WIN - d : -(TB_WIN - d);
+}
+
+// Класс Tablebase - эндшпильные базы, отображенные в память (см. MappedFile).
+// После загрузки только читается, поэтому один объект можно использовать из всех потоков поиска.
+class Tablebase
+{
+  public:
+    // Функция load() открывает файл баз path. Возвращает false, если файла нет или он поврежден;
+    // тогда поиск работает без баз.
+    bool load(const std::string &path)
+    {
+        tables.assign(size_t(TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1),
+                      nullptr);
+        pieces = 0;
+        if (!file.open(path) || file.size() < sizeof(TBFileHeader))
+            return false;
+        TBFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, TB_MAGIC, sizeof(TB_MAGIC)) != 0 || header.version != TB_VERSION ||
+            header.max_pieces > uint32_t(TB_MAX_PIECES) ||
+            file.size() < sizeof(header) + uint64_t(header.table_count) * sizeof(TBFileEntry))
+            return fail();
+        for (uint32_t i = 0; i < header.table_count; ++i)
+        {
+            TBFileEntry entry;
+            std::memcpy(&entry, file.data() + sizeof(header) + i * sizeof(TBFileEntry), sizeof(entry));
+            TBMaterial m;
+            for (int side = 0; side < 2; ++side)
+            {
+                m.men[side] = entry.men[side];
+                m.kings[side] = entry.kings[side];
+            }
+            if (m.pieces() > int(header.max_pieces) || entry.size != m.size() || entry.offset > file.size() ||
+                entry.size > file.size() - entry.offset)
+                return fail();
+            tables[m.slot()] = file.data() + entry.offset;
+        }
+        pieces = int(header.max_pieces);
+        return true;
+    }
+
+    // Функция max_pieces() возвращает наибольшее число фигур в базах (0 - базы не загружены)
+    int max_pieces() const
+    {
+        return pieces;
+    }
+
+    // Функция probe() записывает в score точную оценку позиции pos для стороны pos.color (см. tb_score).
+    // Возвращает false, если позиции нет в базах.
+    bool probe(const Position &pos, int &score) const
+    {
+        const TBKey key = TBKey::of(pos);
+        if (!pieces || !key.valid())
+            return false;
+        const uint8_t *table = tables[key.material().slot()];
+        if (!table)
+            return false;
+        score = tb_score(table[key.index()]);
+        return true;
+    }
+
+  private:
+    bool fail()
+    {
+        file.close();
+        std::fill(tables.begin(), tables.end(), nullptr);
+        return false;
+    }
+
+    MappedFile file;
+    std::vector<const uint8_t *> tables;  // Каталог таблиц по TBMaterial::slot()
+    int pieces = 0;
+};
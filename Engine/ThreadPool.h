@@ -0,0 +1,152 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Класс ThreadPool - пул потоков с перехватом работы (work stealing).
+// У каждого потока своя очередь задач: поток берет задачи из начала своей очереди,
+// а когда она пуста - забирает задачи с конца чужих очередей.
+// Вызывающий поток тоже работает как поток номер 0, поэтому пул из n потоков создает n - 1 новых.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(const unsigned threads)
+    {
+        for (unsigned i = 0; i < threads; ++i)
+            queues.push_back(std::make_unique<Queue>());
+        for (unsigned i = 1; i < threads; ++i)
+            workers.emplace_back([this, i]() { worker_loop(i); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto &th : workers)
+            th.join();
+    }
+
+    unsigned size() const
+    {
+        return unsigned(queues.size());
+    }
+
+    // Функция run() выполняет task(i, worker) для всех i от 0 до count - 1 и ждет завершения всех задач.
+    // worker - номер потока, выполняющего задачу (от 0 до size() - 1).
+    // Задачи раздаются по очередям по кругу, так что первые задачи начинаются первыми.
+    void run(const int count, const std::function<void(int, unsigned)> &task)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            Queue &queue = *queues[i % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(i);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &task;
+            pending = count;
+            ++generation;
+        }
+        wake.notify_all();
+
+        work(0);
+        // Ждем не только выполнения задач, но и выхода всех потоков из work(),
+        // чтобы ни один из них не взял задачу следующего вызова с устаревшей функцией
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return pending == 0 && active == 0; });
+        current = nullptr;
+    }
+
+  private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    // Функция work() выполняет задачи, пока они есть в своей или чужих очередях
+    void work(const unsigned id)
+    {
+        const std::function<void(int, unsigned)> *task;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = current;
+            if (!task)
+                return;
+            ++active;
+        }
+        int index;
+        while (take(id, index))
+        {
+            (*task)(index, id);
+            std::lock_guard<std::mutex> lock(mutex);
+            --pending;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        --active;
+        if (pending == 0 && active == 0)
+            done.notify_all();
+    }
+
+    // Функция take() достает задачу из своей очереди, а если она пуста - перехватывает чужую
+    bool take(const unsigned id, int &index)
+    {
+        for (size_t k = 0; k < queues.size(); ++k)
+        {
+            Queue &queue = *queues[(id + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (k == 0)
+            {
+                index = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            else
+            {
+                index = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void worker_loop(const unsigned id)
+    {
+        uint64_t seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return quit || (generation != seen && current); });
+                if (quit)
+                    return;
+                seen = generation;
+            }
+            work(id);
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    const std::function<void(int, unsigned)> *current = nullptr;
+    int pending = 0;  // Невыполненные задачи текущего вызова run()
+    int active = 0;  // Потоки, находящиеся внутри work()
+    uint64_t generation = 0;
+    bool quit = false;
+};
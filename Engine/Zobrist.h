@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+// Ключи Зобриста для хеширования позиций.
+// Хеш позиции - XOR ключей всех фигур на своих клетках (и ключа очереди хода черных),
+// поэтому при ходе его можно обновлять за несколько операций, не пересчитывая всю доску.
+// Ключи генерируются на этапе компиляции генератором splitmix64 с фиксированным зерном,
+// так что хеши совпадают между запусками и сборками.
+struct Zobrist
+{
+    // piece[type][s]: type - 0 белая шашка, 1 черная шашка, 2 белая дамка, 3 черная дамка
+    uint64_t piece[4][32] = {};
+    uint64_t black_to_move = 0;
+
+    constexpr Zobrist()
+    {
+        uint64_t seed = 0x3243F6A8885A308DULL;
+        for (auto &row : piece)
+        {
+            for (auto &key : row)
+                key = next(seed);
+        }
+        black_to_move = next(seed);
+    }
+
+  private:
+    static constexpr uint64_t next(uint64_t &seed)
+    {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+inline constexpr Zobrist ZOBRIST{};
@@ -16,6 +16,17 @@
 
 using namespace std;
 
+// Структура HistoryStep - шаг хода из истории вместе со всем, что нужно для его отмены
+struct HistoryStep
+{
+    POS_T x, y;  // Откуда ходила шашка
+    POS_T x2, y2;  // Куда ходила шашка
+    POS_T xb, yb;  // Побитая шашка (-1, если взятия не было)
+    POS_T piece;  // Шашка до хода (до превращения в дамку)
+    POS_T captured;  // Побитая шашка (0, если взятия не было)
+    POS_T beat_series;  // Номер шага в серии взятий (0 - не взятие)
+};
+
 // Класс Board представляет игровую доску для шашек
 // Отвечает за отрисовку доски, фигур, перемещение фигур, хранение истории ходов
 // и визуальную обратную связь для игрока
@@ -59,6 +70,7 @@ public:
             print_exception("SDL_CreateWindow can't create window");
             return 1;
         }
+        // SDL_RENDERER_TARGETTEXTURE не требуется: без рисования в текстуру rerender() рисует доску прямо на экран
         ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
         if (ren == nullptr)
         {
@@ -67,18 +79,8 @@ public:
         }
 
         // Загрузка всех необходимых текстур
-        board = IMG_LoadTexture(ren, board_path.c_str());
-        w_piece = IMG_LoadTexture(ren, piece_white_path.c_str());
-        b_piece = IMG_LoadTexture(ren, piece_black_path.c_str());
-        w_queen = IMG_LoadTexture(ren, queen_white_path.c_str());
-        b_queen = IMG_LoadTexture(ren, queen_black_path.c_str());
-        back = IMG_LoadTexture(ren, back_path.c_str());
-        replay = IMG_LoadTexture(ren, replay_path.c_str());
-        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay)
-        {
-            print_exception("IMG_LoadTexture can't load main textures from " + textures_path);
+        if (!load_textures())
             return 1;
-        }
 
         // Получение фактических размеров окна и инициализация начального состояния доски
         SDL_GetRendererOutputSize(ren, &W, &H);
@@ -92,8 +94,7 @@ public:
     void redraw()
     {
         game_results = -1;
-        history_mtx.clear();
-        history_beat_series.clear();
+        history.clear();
         make_start_mtx();
         clear_active();
         clear_highlight();
@@ -101,19 +102,10 @@ public:
 
     // Функция move_piece() перемещает шашку согласно переданному ходу
     // Если ход содержит взятие (turn.xb != -1), удаляет побитую шашку
-    void move_piece(move_pos turn, const int beat_series = 0)
-    {
-        if (turn.xb != -1)
-        {
-            mtx[turn.xb][turn.yb] = 0;  // Удаление побитой шашки
-        }
-        move_piece(turn.x, turn.y, turn.x2, turn.y2, beat_series);
-    }
-
-    // Перегруженная функция move_piece() для перемещения шашки по координатам
     // Также проверяет возможность превращения в дамку
-    void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
+    void move_piece(move_pos turn, const int beat_series = 0)
     {
+        const POS_T i = turn.x, j = turn.y, i2 = turn.x2, j2 = turn.y2;
         // Проверки на корректность хода
         if (mtx[i2][j2])
         {
@@ -124,13 +116,27 @@ public:
             throw runtime_error("begin position is empty, can't move");
         }
 
+        // Запись хода в историю до его выполнения: нужны шашка до превращения и побитая шашка
+        HistoryStep step{ i, j, i2, j2, turn.xb, turn.yb, mtx[i][j], 0, POS_T(beat_series) };
+        if (turn.xb != -1)
+        {
+            step.captured = mtx[turn.xb][turn.yb];
+            mtx[turn.xb][turn.yb] = 0;  // Удаление побитой шашки
+        }
+        history.push_back(step);
+
         // Превращение в дамку при достижении последней горизонтали
         if ((mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7))
             mtx[i][j] += 2;
 
         mtx[i2][j2] = mtx[i][j];  // Перемещение шашки на новую позицию
         drop_piece(i, j);  // Удаление шашки с исходной позиции
-        add_history(beat_series);  // Добавление хода в историю
+    }
+
+    // Перегруженная функция move_piece() для перемещения шашки по координатам (без взятия)
+    void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
+    {
+        move_piece(move_pos(i, j, i2, j2), beat_series);
     }
 
     // Функция drop_piece() удаляет шашку с указанной позиции
@@ -204,17 +210,27 @@ public:
     // Учитывает серию взятий как один полный ход
     void rollback()
     {
-        auto beat_series = max(1, *(history_beat_series.rbegin()));
-        while (beat_series-- && history_mtx.size() > 1)
+        int beat_series = history.empty() ? 0 : max(1, int(history.back().beat_series));
+        while (beat_series-- && !history.empty())
         {
-            history_mtx.pop_back();
-            history_beat_series.pop_back();
+            // Обратный ход: шашка возвращается в прежнем виде, побитая шашка - на свое место
+            const HistoryStep& step = history.back();
+            mtx[step.x2][step.y2] = 0;
+            mtx[step.x][step.y] = step.piece;
+            if (step.xb != -1)
+                mtx[step.xb][step.yb] = step.captured;
+            history.pop_back();
         }
-        mtx = *(history_mtx.rbegin());  // Восстановление состояния доски из истории
         clear_highlight();
         clear_active();
     }
 
+    // Функция history_size() возвращает число позиций в истории вместе с начальной
+    size_t history_size() const
+    {
+        return history.size() + 1;
+    }
+
     // Функция show_final() отображает результат игры
     // res: 0 - ничья, 1 - победа белых, 2 - победа черных
     void show_final(const int res)
@@ -227,19 +243,37 @@ public:
     void reset_window_size()
     {
         SDL_GetRendererOutputSize(ren, &W, &H);
+        // Слой доски создается заново под новый размер окна
+        SDL_DestroyTexture(scene);
+        scene = nullptr;
+        rerender();
+    }
+
+    // Функция reset_render() восстанавливает графику после сброса рендерера (бывает в Direct3D):
+    // при SDL_RENDER_TARGETS_RESET пропадает содержимое слоя доски, и он перерисовывается,
+    // а при SDL_RENDER_DEVICE_RESET (device_lost) пропадают все текстуры, и они загружаются заново
+    void reset_render(const bool device_lost)
+    {
+        if (device_lost)
+        {
+            destroy_textures();
+            if (!load_textures())
+                return;
+        }
+        scene_mtx.clear();
         rerender();
     }
 
+    // Функция set_title() меняет заголовок окна
+    void set_title(const string& title)
+    {
+        SDL_SetWindowTitle(win, title.c_str());
+    }
+
     // Функция quit() освобождает все ресурсы SDL и закрывает окно
     void quit()
     {
-        SDL_DestroyTexture(board);
-        SDL_DestroyTexture(w_piece);
-        SDL_DestroyTexture(b_piece);
-        SDL_DestroyTexture(w_queen);
-        SDL_DestroyTexture(b_queen);
-        SDL_DestroyTexture(back);
-        SDL_DestroyTexture(replay);
+        destroy_textures();
         SDL_DestroyRenderer(ren);
         SDL_DestroyWindow(win);
         SDL_Quit();
@@ -252,11 +286,37 @@ public:
     }
 
 private:
-    // Функция add_history() добавляет текущее состояние доски в историю ходов
-    void add_history(const int beat_series = 0)
+    // Функция load_textures() загружает все текстуры. Возвращает false, если какую-то загрузить не удалось
+    bool load_textures()
     {
-        history_mtx.push_back(mtx);
-        history_beat_series.push_back(beat_series);
+        board = IMG_LoadTexture(ren, board_path.c_str());
+        w_piece = IMG_LoadTexture(ren, piece_white_path.c_str());
+        b_piece = IMG_LoadTexture(ren, piece_black_path.c_str());
+        w_queen = IMG_LoadTexture(ren, queen_white_path.c_str());
+        b_queen = IMG_LoadTexture(ren, queen_black_path.c_str());
+        back = IMG_LoadTexture(ren, back_path.c_str());
+        replay = IMG_LoadTexture(ren, replay_path.c_str());
+        white_wins = IMG_LoadTexture(ren, white_path.c_str());
+        black_wins = IMG_LoadTexture(ren, black_path.c_str());
+        draw_result = IMG_LoadTexture(ren, draw_path.c_str());
+        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay || !white_wins ||
+            !black_wins || !draw_result)
+        {
+            print_exception("IMG_LoadTexture can't load main textures from " + textures_path);
+            return false;
+        }
+        return true;
+    }
+
+    // Функция destroy_textures() освобождает все текстуры, включая слой доски
+    void destroy_textures()
+    {
+        for (SDL_Texture** texture : { &board, &w_piece, &b_piece, &w_queen, &b_queen, &back, &replay, &white_wins,
+                                       &black_wins, &draw_result, &scene })
+        {
+            SDL_DestroyTexture(*texture);
+            *texture = nullptr;
+        }
     }
 
     // Функция make_start_mtx() создает начальную расстановку шашек на доске
@@ -274,43 +334,33 @@ private:
                     mtx[i][j] = 1;  // Белые шашки в нижней части
             }
         }
-        add_history();
     }
 
     // Функция rerender() перерисовывает всю графику игры
-    // Отображает доску, шашки, подсветку, активную шашку и результат игры (если есть)
+    // Доска, шашки и кнопки берутся из слоя scene, который перерисовывается только после изменения доски;
+    // поверх слоя рисуются подсветка, активная шашка и результат игры (если есть)
     void rerender()
     {
-        // Отрисовка доски
-        SDL_RenderClear(ren);
-        SDL_RenderCopy(ren, board, NULL, NULL);
-
-        // Отрисовка шашек
-        for (POS_T i = 0; i < 8; ++i)
+        if (!scene && scene_supported)
         {
-            for (POS_T j = 0; j < 8; ++j)
-            {
-                if (!mtx[i][j])
-                    continue;
-                int wpos = W * (j + 1) / 10 + W / 120;
-                int hpos = H * (i + 1) / 10 + H / 120;
-                SDL_Rect rect{ wpos, hpos, W / 12, H / 12 };
-
-                // Выбор текстуры в зависимости от типа шашки:
-                // 1 - белая шашка, 2 - черная шашка, 3 - белая дамка, 4 - черная дамка
-                SDL_Texture* piece_texture;
-                if (mtx[i][j] == 1)
-                    piece_texture = w_piece;
-                else if (mtx[i][j] == 2)
-                    piece_texture = b_piece;
-                else if (mtx[i][j] == 3)
-                    piece_texture = w_queen;
-                else
-                    piece_texture = b_queen;
-
-                SDL_RenderCopy(ren, piece_texture, NULL, &rect);
-            }
+            scene = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, W, H);
+            // Если рендерер не умеет рисовать в текстуру, больше не пытаемся
+            scene_supported = scene != nullptr;
+            scene_mtx.clear();
         }
+        if (scene && scene_mtx != mtx)
+        {
+            SDL_SetRenderTarget(ren, scene);
+            draw_scene();
+            SDL_SetRenderTarget(ren, NULL);
+            scene_mtx = mtx;
+        }
+
+        SDL_RenderClear(ren);
+        if (scene)
+            SDL_RenderCopy(ren, scene, NULL, NULL);
+        else
+            draw_scene();  // Рендерер не умеет рисовать в текстуру: слой рисуется каждый раз
 
         // Отрисовка подсветки возможных ходов (зеленым цветом)
         SDL_SetRenderDrawColor(ren, 0, 255, 0, 0);
@@ -338,37 +388,62 @@ private:
         }
         SDL_RenderSetScale(ren, 1, 1);
 
-        // Отрисовка кнопок управления (отмена хода и перезапуск)
-        SDL_Rect rect_left{ W / 40, H / 40, W / 15, H / 15 };
-        SDL_RenderCopy(ren, back, NULL, &rect_left);
-        SDL_Rect replay_rect{ W * 109 / 120, H / 40, W / 15, H / 15 };
-        SDL_RenderCopy(ren, replay, NULL, &replay_rect);
-
         // Отрисовка результата игры (если игра завершена)
         if (game_results != -1)
         {
-            string result_path = draw_path;
+            SDL_Texture* result_texture = draw_result;
             if (game_results == 1)
-                result_path = white_path;  // Победа белых
+                result_texture = white_wins;  // Победа белых
             else if (game_results == 2)
-                result_path = black_path;  // Победа черных
-            SDL_Texture* result_texture = IMG_LoadTexture(ren, result_path.c_str());
-            if (result_texture == nullptr)
-            {
-                print_exception("IMG_LoadTexture can't load game result picture from " + result_path);
-                return;
-            }
+                result_texture = black_wins;  // Победа черных
             SDL_Rect res_rect{ W / 5, H * 3 / 10, W * 3 / 5, H * 2 / 5 };
             SDL_RenderCopy(ren, result_texture, NULL, &res_rect);
-            SDL_DestroyTexture(result_texture);
         }
 
-        // Обновление экрана
+        // Обновление экрана. События здесь не разбираются: их ждут Hand::get_cell(), Hand::wait()
+        // и Hand::wait_bot(), которые заодно обрабатывают окно на Mac OS
         SDL_RenderPresent(ren);
-        // Короткая задержка и обработка событий для Mac OS
-        SDL_Delay(10);
-        SDL_Event windowEvent;
-        SDL_PollEvent(&windowEvent);
+    }
+
+    // Функция draw_scene() рисует доску, шашки и кнопки управления
+    void draw_scene()
+    {
+        // Отрисовка доски
+        SDL_RenderClear(ren);
+        SDL_RenderCopy(ren, board, NULL, NULL);
+
+        // Отрисовка шашек
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                if (!mtx[i][j])
+                    continue;
+                int wpos = W * (j + 1) / 10 + W / 120;
+                int hpos = H * (i + 1) / 10 + H / 120;
+                SDL_Rect rect{ wpos, hpos, W / 12, H / 12 };
+
+                // Выбор текстуры в зависимости от типа шашки:
+                // 1 - белая шашка, 2 - черная шашка, 3 - белая дамка, 4 - черная дамка
+                SDL_Texture* piece_texture;
+                if (mtx[i][j] == 1)
+                    piece_texture = w_piece;
+                else if (mtx[i][j] == 2)
+                    piece_texture = b_piece;
+                else if (mtx[i][j] == 3)
+                    piece_texture = w_queen;
+                else
+                    piece_texture = b_queen;
+
+                SDL_RenderCopy(ren, piece_texture, NULL, &rect);
+            }
+        }
+
+        // Отрисовка кнопок управления (отмена хода и перезапуск)
+        SDL_Rect rect_left{ W / 40, H / 40, W / 15, H / 15 };
+        SDL_RenderCopy(ren, back, NULL, &rect_left);
+        SDL_Rect replay_rect{ W * 109 / 120, H / 40, W / 15, H / 15 };
+        SDL_RenderCopy(ren, replay, NULL, &replay_rect);
     }
 
     // Функция print_exception() записывает сообщение об ошибке в лог-файл
@@ -381,8 +456,6 @@ private:
 public:
     int W = 0;  // Ширина окна
     int H = 0;  // Высота окна
-    // История состояний доски для отмены ходов
-    vector<vector<vector<POS_T>>> history_mtx;
 
 private:
     SDL_Window* win = nullptr;  // Окно SDL
@@ -396,6 +469,15 @@ private:
     SDL_Texture* b_queen = nullptr;  // Черная дамка
     SDL_Texture* back = nullptr;  // Кнопка отмены хода
     SDL_Texture* replay = nullptr;  // Кнопка перезапуска игры
+    SDL_Texture* white_wins = nullptr;  // Результат: победа белых
+    SDL_Texture* black_wins = nullptr;  // Результат: победа черных
+    SDL_Texture* draw_result = nullptr;  // Результат: ничья
+
+    // Слой с доской, шашками и кнопками (nullptr, если еще не создан или рендерер не рисует в текстуру)
+    SDL_Texture* scene = nullptr;
+    bool scene_supported = true;  // false, если создать слой не удалось: тогда он рисуется прямо на экран
+    // Состояние доски, нарисованное в слое scene (пусто, если слой не нарисован)
+    vector<vector<POS_T>> scene_mtx;
 
     // Пути к файлам текстур
     const string textures_path = project_path + "Textures/";
@@ -423,6 +505,7 @@ private:
     // 0 - пусто, 1 - белая шашка, 2 - черная шашка, 3 - белая дамка, 4 - черная дамка
     vector<vector<POS_T>> mtx = vector<vector<POS_T>>(8, vector<POS_T>(8, 0));
 
-    // История серий взятий для каждого хода (для корректной отмены ходов)
-    vector<int> history_beat_series;
-};
\ No newline at end of file
+    // История ходов для отмены: шаги от начальной позиции, каждый шаг серии взятий отдельно.
+    // Доска восстанавливается обратными ходами, поэтому снимки доски не хранятся
+    vector<HistoryStep> history;
+};
\ No newline at end of file
@@ -1,5 +1,8 @@
 ﻿#pragma once
 #include <chrono>
+#include <future>
+#include <mutex>
+#include <stop_token>
 #include <thread>
 
 #include "../Models/Project_path.h"
@@ -49,6 +52,8 @@ public:
             {
                 // Обработка хода игрока
                 auto resp = player_turn(turn_num % 2);
+                if (resp != Response::OK)
+                    logic.stop_pondering();
                 if (resp == Response::QUIT)  // Если игрок решил выйти
                 {
                     is_quit = true;
@@ -63,7 +68,7 @@ public:
                 {
                     // Логика отмены ходов с учетом типа противника (бот/игрок)
                     if (config("Bot", string("Is") + string((1 - turn_num % 2) ? "Black" : "White") + string("Bot")) &&
-                        !beat_series && board.history_mtx.size() > 2)
+                        !beat_series && board.history_size() > 2)
                     {
                         board.rollback();
                         --turn_num;
@@ -77,8 +82,33 @@ public:
                 }
             }
             else
-                bot_turn(turn_num % 2);  // Обработка хода бота
+            {
+                auto resp = bot_turn(turn_num % 2);  // Обработка хода бота
+                if (resp == Response::QUIT)
+                {
+                    is_quit = true;
+                    break;
+                }
+                else if (resp == Response::REPLAY)
+                {
+                    is_replay = true;
+                    break;
+                }
+                else if (resp == Response::BACK)
+                {
+                    // Поиск прерван до хода бота: отменяется последний ход соперника, и он ходит снова
+                    board.rollback();
+                    turn_num -= 2;
+                }
+                // Пока соперник-человек думает (в том числе заново после отмены хода), бот обдумывает
+                // ответы на его ходы
+                if (config("Bot", "Ponder") &&
+                    !config("Bot", string("Is") + string((1 - turn_num % 2) ? "Black" : "White") + string("Bot")))
+                    logic.start_pondering(1 - turn_num % 2);
+            }
         }
+        // Партия закончена: обдумывание ответов больше не нужно и не должно занимать процессор
+        logic.stop_pondering();
         // Запись времени игры в лог
         auto end = chrono::steady_clock::now();
         ofstream fout(project_path + "log.txt", ios_base::app);
@@ -114,15 +144,61 @@ public:
     }
 
 private:
-    void bot_turn(const bool color)
+    // Функция bot_turn() делает ход бота цвета color. Поиск идет в отдельном потоке, а окно тем временем
+    // обрабатывает события: закрытие окна, отмена хода и новая игра прерывают поиск за несколько миллисекунд.
+    // Возвращает Response::OK, если ход сделан, иначе действие игрока (ход тогда не делается).
+    Response bot_turn(const bool color)
     {
         auto start = chrono::steady_clock::now();
 
-        auto delay_ms = config("Bot", "BotDelayMS");
-        // new thread for equal delay for each turn
-        thread th(SDL_Delay, delay_ms);
-        auto turns = logic.find_best_turns(color);
-        th.join();
+        const int delay_ms = config("Bot", "BotDelayMS");
+        // Ход показывается не раньше чем через BotDelayMS после начала, сколько бы ни длился поиск
+        const auto show_time = start + chrono::milliseconds(delay_ms);
+        stop_source cancel;
+        mutex progress_mutex;
+        SearchProgress progress{-1, 0, {}, 0};  // Последняя завершенная итерация поиска
+        auto search = async(launch::async, [&]() {
+            auto turns = logic.find_best_turns(color, cancel.get_token(), [&](const SearchProgress &p) {
+                lock_guard<mutex> lock(progress_mutex);
+                progress = p;
+            });
+            hand.notify_search_done();
+            return turns;
+        });
+        // Окно спит до конца поиска или до действия игрока. Ожидание ограничено на случай,
+        // если событие конца поиска не попадет в переполненную очередь SDL, а заодно раз в 100 мс
+        // в заголовке окна обновляется ход размышлений бота
+        int shown_depth = -1;  // Итерация, показанная в заголовке
+        while (true)
+        {
+            const bool ready = search.wait_for(chrono::milliseconds(0)) == future_status::ready;
+            const auto now = chrono::steady_clock::now();
+            if (ready && now >= show_time)
+                break;
+            int timeout_ms = 100;
+            if (ready)
+                timeout_ms = int(chrono::duration_cast<chrono::milliseconds>(show_time - now).count()) + 1;
+            auto resp = hand.wait_bot(timeout_ms);
+            if (resp != Response::OK)
+            {
+                cancel.request_stop();
+                search.wait();
+                board.set_title("Checkers");
+                return resp;
+            }
+            SearchProgress shown;
+            {
+                lock_guard<mutex> lock(progress_mutex);
+                if (progress.depth == shown_depth)
+                    continue;
+                shown = progress;
+            }
+            shown_depth = shown.depth;
+            board.set_title("Checkers - depth " + to_string(shown.depth + 1) + ", nodes " + to_string(shown.nodes) +
+                            ", best " + turn_name(shown.best));
+        }
+        board.set_title("Checkers");
+        auto turns = search.get();
         bool is_first = true;
         // making moves
         for (auto turn : turns)
@@ -138,9 +214,27 @@ private:
 
         auto end = chrono::steady_clock::now();
         ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Bot turn time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
+        fout << "Bot turn time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec";
+        if (progress.depth >= 0)
+            fout << ", depth " << progress.depth + 1 << ", nodes " << progress.nodes;
+        fout << "\n";
         fout.close();
+        return Response::OK;
+    }
+    // Функция turn_name() записывает ход с серией взятий в шашечной нотации: "c3-d4", "c3:e5:c7"
+    static string turn_name(const vector<move_pos>& steps)
+    {
+        string name;
+        for (const move_pos& step : steps)
+        {
+            if (name.empty())
+                name += string{ char('a' + step.y), char('8' - step.x) };
+            name += step.xb != -1 ? ':' : '-';
+            name += string{ char('a' + step.y2), char('8' - step.x2) };
+        }
+        return name;
     }
+
     // Функция player_turn() обрабатывает ход игрока указанного цвета (color: 0 - белые, 1 - черные)
     // Возвращает Response с результатом действия игрока
     Response player_turn(const bool color)
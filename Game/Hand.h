@@ -7,12 +7,28 @@
 
 // Класс Hand отвечает за обработку пользовательского ввода и взаимодействие
 // с игровой доской через события SDL (клики мыши, изменение размера окна и т.д.)
+// Ожидание ввода не занимает процессор: поток спит в SDL_WaitEvent, пока не придет событие,
+// а поиск бота будит его своим событием (см. notify_search_done).
 class Hand
 {
   public:
-    Hand(Board *board) : board(board)
+    Hand(Board *board) : board(board), search_done_event(SDL_RegisterEvents(1))
     {
     }
+
+    // Функция notify_search_done() сообщает окну, что поиск бота закончился.
+    // Вызывается из потока поиска: SDL_PushEvent можно вызывать из любого потока.
+    // Если свободных пользовательских событий SDL не осталось, ничего не делает:
+    // окно тогда узнает о конце поиска по таймауту wait_bot().
+    void notify_search_done() const
+    {
+        if (search_done_event == Uint32(-1))
+            return;
+        SDL_Event event{};
+        event.type = search_done_event;
+        SDL_PushEvent(&event);
+    }
+
     // Функция get_cell() ожидает выбора клетки пользователем и возвращает тип реакции
     // и координаты выбранной клетки (если таковая имеется)
     // Возвращает:
@@ -28,7 +44,8 @@ class Hand
         int xc = -1, yc = -1;
         while (true)
         {
-            if (SDL_PollEvent(&windowEvent))
+            // Поток спит, пока нет событий, а не опрашивает очередь в цикле
+            if (SDL_WaitEvent(&windowEvent))
             {
                 switch (windowEvent.type)
                 {
@@ -41,7 +58,7 @@ class Hand
                     y = windowEvent.motion.y;
                     xc = int(y / (board->H / 10) - 1);  // Пересчет координат экрана в координаты доски
                     yc = int(x / (board->W / 10) - 1);
-                    if (xc == -1 && yc == -1 && board->history_mtx.size() > 1)
+                    if (xc == -1 && yc == -1 && board->history_size() > 1)
                     {
                         resp = Response::BACK;  // Клик по кнопке "отмена хода"
                     }
@@ -59,6 +76,11 @@ class Hand
                         yc = -1;
                     }
                     break;
+                case SDL_RENDER_TARGETS_RESET:
+                case SDL_RENDER_DEVICE_RESET:
+                    // Рендерер сброшен (Direct3D): слой доски, а то и все текстуры, нужно нарисовать заново
+                    board->reset_render(windowEvent.type == SDL_RENDER_DEVICE_RESET);
+                    break;
                 case SDL_WINDOWEVENT:
                     // Обработка изменения размера окна
                     if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
@@ -73,6 +95,49 @@ class Hand
         }
         return {resp, xc, yc};
     }
+
+    // Функция wait_bot() ждет, пока ищет бот, одно событие не дольше timeout_ms миллисекунд
+    // (событие конца поиска от notify_search_done() будит ее сразу) и обрабатывает все накопившиеся.
+    // Изменение размера окна обрабатывается сразу, клики по клеткам доски пропускаются.
+    // Возвращает:
+    // - Response::QUIT - если пользователь закрыл окно
+    // - Response::BACK - если пользователь нажал кнопку отмены хода
+    // - Response::REPLAY - если пользователь нажал кнопку перезапуска
+    // - Response::OK - если ничего из этого не произошло
+    Response wait_bot(const int timeout_ms) const
+    {
+        SDL_Event windowEvent;
+        if (!SDL_WaitEventTimeout(&windowEvent, timeout_ms))
+            return Response::OK;
+        do
+        {
+            switch (windowEvent.type)
+            {
+            case SDL_QUIT:
+                return Response::QUIT;
+            case SDL_MOUSEBUTTONDOWN: {
+                int xc = int(windowEvent.motion.y / (board->H / 10) - 1);
+                int yc = int(windowEvent.motion.x / (board->W / 10) - 1);
+                if (xc == -1 && yc == -1 && board->history_size() > 1)
+                    return Response::BACK;
+                if (xc == -1 && yc == 8)
+                    return Response::REPLAY;
+            }
+            break;
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                // Рендерер сброшен (Direct3D): слой доски, а то и все текстуры, нужно нарисовать заново
+                board->reset_render(windowEvent.type == SDL_RENDER_DEVICE_RESET);
+                break;
+            case SDL_WINDOWEVENT:
+                if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                    board->reset_window_size();
+                break;
+            }
+        } while (SDL_PollEvent(&windowEvent));
+        return Response::OK;
+    }
+
     // Функция wait() ожидает любое действие пользователя (клик, закрытие окна)
     // Используется в конце игры или при ожидании решения пользователя
     // Возвращает:
@@ -84,15 +149,23 @@ class Hand
         Response resp = Response::OK;
         while (true)
         {
-            if (SDL_PollEvent(&windowEvent))
+            // Поток спит, пока нет событий, а не опрашивает очередь в цикле
+            if (SDL_WaitEvent(&windowEvent))
             {
                 switch (windowEvent.type)
                 {
                 case SDL_QUIT:
                     resp = Response::QUIT;  // Пользователь закрыл окно
                     break;
-                case SDL_WINDOWEVENT_SIZE_CHANGED:
-                    board->reset_window_size();  // Обработка изменения размера окна
+                case SDL_RENDER_TARGETS_RESET:
+                case SDL_RENDER_DEVICE_RESET:
+                    // Рендерер сброшен (Direct3D): слой доски, а то и все текстуры, нужно нарисовать заново
+                    board->reset_render(windowEvent.type == SDL_RENDER_DEVICE_RESET);
+                    break;
+                case SDL_WINDOWEVENT:
+                    // Обработка изменения размера окна
+                    if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                        board->reset_window_size();
                     break;
                 case SDL_MOUSEBUTTONDOWN: {
                     // Обработка клика мыши
@@ -114,4 +187,6 @@ class Hand
 
   private:
     Board *board;  // Указатель на игровую доску
+    // Тип пользовательского события SDL "поиск бота закончился" (Uint32(-1), если SDL не выделил событие)
+    Uint32 search_done_event;
 };
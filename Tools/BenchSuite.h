@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Структура BenchCase - позиция для замера скорости поиска и уровень бота (глубина - level + 1 ход)
+struct BenchCase
+{
+    std::string name;
+    std::string position;  // В формате Position::to_string()
+    int level;
+};
+
+// Набор позиций не меняется, чтобы результаты разных сборок можно было сравнивать между собой
+inline const std::vector<BenchCase> BENCH_SUITE = {
+    {"start", "w bbbb/bbbb/bbbb/..../..../wwww/wwww/wwww", 13},
+    {"capture-choice", "b b.bb/bbb./.b../bb../.b.b/w.ww/w..b/wwww", 14},
+    {"flying-king", "w b..b/b.../..b./.b../..../W.ww/w..w/wwww", 11},
+    {"kings", "b .bb./bbb./bb../b.../..../..Bw/..../W..w", 11},
+    {"middlegame", "w bbbb/..../b..b/..b./w.../..../.w.w/wwww", 12},
+    {"endgame", "w bbb./...b/..../..../...w/..../...w/Bw..", 13},
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Engine/Book.h"
+#include "../Engine/Engine.h"
+#include "../Engine/ThreadPool.h"
+
+// Ходы, которые уступают лучшему не больше BOOK_MARGIN (около 0.1 шашки в начале партии), попадают в книгу
+const int BOOK_MARGIN = SCORE_SCALE / 256;
+
+// Функция score_position() оценивает позицию pos поиском на уровне level для стороны, которая ходит.
+// Поиск не оценивает позицию с единственным ходом, поэтому такие ходы сначала делаются.
+inline int score_position(Engine &engine, Position pos, int level)
+{
+    int sign = 1;
+    while (true)
+    {
+        MoveList turns;
+        generate_turns(pos, turns);
+        if (turns.empty())
+            return -sign * INF;
+        if (turns.size > 1)
+            break;
+        pos.make_move(turns[0]);
+        pos.pass_turn();
+        sign = -sign;
+        level = std::max(level - 1, 0);
+    }
+    engine.find_best_turns(pos, level);
+    return sign * engine.score();
+}
+
+// Класс BookBuilder собирает дебютную книгу (формат - см. Engine/Book.h) по результатам поиска:
+// в каждой позиции оцениваются все ходы, и в книгу попадают близкие по оценке к лучшему
+// с весом тем больше, чем ближе оценка (лучший ход - 256, ход на границе BOOK_MARGIN - 1).
+// Можно вызывать из нескольких потоков.
+class BookBuilder
+{
+  public:
+    // Функция analyse() возвращает ходы книги для позиции pos, оценивая ее движком engine на уровне level,
+    // если она встретилась впервые
+    std::vector<BookEntry> analyse(const Position &pos, Engine &engine, const int level)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it = positions.find(pos.hash);
+            if (it != positions.end())
+                return it->second;
+        }
+        MoveList turns;
+        generate_turns(pos, turns);
+        std::vector<int> scores;
+        // Единственный ход оценивать не нужно
+        for (const Move &turn : turns)
+        {
+            if (turns.size == 1)
+            {
+                scores.push_back(0);
+                break;
+            }
+            Position next = pos;
+            next.make_move(turn);
+            next.pass_turn();
+            scores.push_back(-score_position(engine, next, std::max(level - 1, 0)));
+        }
+        std::vector<BookEntry> entries;
+        if (!scores.empty())
+        {
+            const int best = *std::max_element(scores.begin(), scores.end());
+            for (int i = 0; i < turns.size; ++i)
+            {
+                if (best - scores[i] > BOOK_MARGIN)
+                    continue;
+                const int weight = 1 + int(int64_t(255) * (BOOK_MARGIN - (best - scores[i])) / BOOK_MARGIN);
+                entries.push_back(BookEntry{pos.hash, turns[i].captured, turns[i].from, turns[i].to, uint16_t(weight)});
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return positions.emplace(pos.hash, entries).first->second;
+    }
+
+    // Функция size() возвращает число позиций в книге
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return positions.size();
+    }
+
+    // Функция write() записывает книгу в файл path
+    void write(const std::string &path) const
+    {
+        std::vector<BookEntry> entries;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &[key, moves] : positions)
+                entries.insert(entries.end(), moves.begin(), moves.end());
+        }
+        // map уже упорядочен по хешу, остается упорядочить ходы позиции по весу
+        std::stable_sort(entries.begin(), entries.end(), [](const BookEntry &a, const BookEntry &b) {
+            return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+        });
+        std::ofstream fout(path, std::ios::binary);
+        if (!fout)
+            throw std::runtime_error("cannot open " + path);
+        BookFileHeader header{};
+        std::copy(BOOK_MAGIC, BOOK_MAGIC + sizeof(BOOK_MAGIC), header.magic);
+        header.version = BOOK_VERSION;
+        header.count = uint32_t(entries.size());
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        fout.write(reinterpret_cast<const char *>(entries.data()), std::streamsize(entries.size() * sizeof(BookEntry)));
+        if (!fout)
+            throw std::runtime_error("cannot write " + path);
+    }
+
+  private:
+    mutable std::mutex mutex;
+    std::map<uint64_t, std::vector<BookEntry>> positions;  // Ходы книги по хешу позиции
+};
+
+// Функция build_book() проходит games случайных партий по ходам книги на глубину plies ходов,
+// оценивая встреченные позиции (см. BookBuilder::analyse) детерминированным ботом с настройками settings
+// на уровне level. Партии идут параллельно в threads потоках (0 - по числу ядер), у каждого потока свой бот,
+// а следующий ход партии выбирается случайно с учетом весов, поэтому партии расходятся по разным дебютам.
+inline void build_book(BookBuilder &builder, EngineSettings settings, const int games, const int plies,
+                       const int level, const unsigned threads, const unsigned seed)
+{
+    settings.no_random = true;
+    settings.threads = 1;
+    settings.book_path.clear();
+    ThreadPool pool(threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::unique_ptr<Engine>> engines;
+    for (unsigned i = 0; i < pool.size(); ++i)
+        engines.push_back(std::make_unique<Engine>(settings));
+    pool.run(games, [&](const int game, const unsigned worker) {
+        std::default_random_engine rng(seed + unsigned(game));
+        Position pos = Position::start();
+        for (int ply = 0; ply < plies; ++ply)
+        {
+            const std::vector<BookEntry> entries = builder.analyse(pos, *engines[worker], level);
+            if (entries.empty())
+                break;
+            std::vector<int> weights;
+            for (const BookEntry &entry : entries)
+                weights.push_back(entry.weight);
+            const BookEntry &entry = entries[std::discrete_distribution<size_t>(weights.begin(), weights.end())(rng)];
+            MoveList turns;
+            generate_turns(pos, turns);
+            for (const Move &turn : turns)
+            {
+                if (turn.from == entry.from && turn.to == entry.to && turn.captured == entry.captured)
+                {
+                    pos.make_move(turn);
+                    break;
+                }
+            }
+            pos.pass_turn();
+        }
+    });
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Структура PerftCase - позиция для проверки генератора ходов и эталонное число позиций
+// на глубинах 1, 2, ... (nodes[d - 1] - для глубины d).
+// Эталоны посчитаны исходным генератором Logic::find_turns на матрице доски и совпадают с perft().
+struct PerftCase
+{
+    std::string name;
+    std::string position;  // В формате Position::to_string()
+    std::vector<uint64_t> nodes;
+};
+
+inline const std::vector<PerftCase> PERFT_SUITE = {
+    {"start", "w bbbb/bbbb/bbbb/..../..../wwww/wwww/wwww",
+     {7, 49, 302, 1469, 7482, 37986, 190146, 929984, 4571392, 22487389}},
+    // Единственный ход белых - серия из трех взятий
+    {"multi-capture", "w bbb./.bbb/b..b/bb.b/.bww/w.ww/www./ww.w",
+     {1, 9, 47, 266, 1658, 9176, 55332, 293340, 1719353}},
+    // Белая дамка бьет издалека и может остановиться на любой свободной клетке за побитой фигурой
+    {"flying-king", "w b..b/b.../..b./.b../..../W.ww/w..w/wwww",
+     {4, 16, 212, 981, 10716, 46931, 454608, 1898244, 16538864}},
+    // Дамки у обеих сторон, ход черных
+    {"kings", "b .bb./bbb./bb../b.../..../..Bw/..../W..w",
+     {14, 101, 777, 5301, 40469, 271194, 2099720, 13628127}},
+};
@@ -0,0 +1,269 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Engine/MoveGen.h"
+#include "../Engine/Tablebase.h"
+#include "../Engine/ThreadPool.h"
+
+// Класс TablebaseGenerator строит эндшпильные базы (формат - см. Engine/Tablebase.h)
+// для всех позиций не более чем с pieces фигурами обратным анализом (retrograde analysis):
+// сначала отмечаются проигрыши без ходов, затем на проходе k - позиции, решенные ровно за k ходов:
+// выигрыш, если есть ход в проигрыш за k - 1, и проигрыш, если все ходы ведут в выигрыши соперника
+// не дольше k - 1. Позиции, не решенные, когда проходы перестают что-то менять, - ничьи.
+// Взятие уменьшает число фигур, а превращение - число шашек, поэтому таблицы решаются по возрастанию
+// числа фигур и затем шашек, и ход ведет либо в уже готовую таблицу, либо в решаемую вместе с текущей
+// (для соперника та же таблица с переставленными сторонами). Проход делится между потоками пула.
+class TablebaseGenerator
+{
+  public:
+    TablebaseGenerator(const int pieces, const unsigned threads)
+        : pieces(pieces),
+          pool(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+          directory(size_t(TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1) * (TB_MAX_PIECES + 1))
+    {
+        if (pieces < 2 || pieces > TB_MAX_PIECES)
+            throw std::invalid_argument("tablebase pieces must be from 2 to " + std::to_string(TB_MAX_PIECES));
+        for (int total = 2; total <= pieces; ++total)
+            for (int men0 = 0; men0 <= total; ++men0)
+                for (int men1 = 0; men0 + men1 <= total; ++men1)
+                    for (int kings0 = 0; men0 + men1 + kings0 <= total; ++kings0)
+                    {
+                        TBMaterial m;
+                        m.men[0] = men0;
+                        m.men[1] = men1;
+                        m.kings[0] = kings0;
+                        m.kings[1] = total - men0 - men1 - kings0;
+                        if (m.men[0] + m.kings[0] > 0 && m.men[1] + m.kings[1] > 0)
+                            tables.push_back(Table{m, {}});
+                    }
+        // По возрастанию числа фигур, затем шашек (stable_sort сохраняет порядок перечисления)
+        std::stable_sort(tables.begin(), tables.end(), [](const Table &a, const Table &b) {
+            return stage_of(a.material) < stage_of(b.material);
+        });
+    }
+
+    // Функция run() строит все таблицы, печатая в log итоги по каждой
+    void run(std::ostream &log)
+    {
+        for (Table &table : tables)
+        {
+            table.values.assign(table.material.size(), 0);
+            directory[table.material.slot()] = table.values.data();
+        }
+        for (size_t first = 0; first < tables.size();)
+        {
+            size_t last = first;
+            while (last < tables.size() && stage_of(tables[last].material) == stage_of(tables[first].material))
+                ++last;
+            const auto start = std::chrono::steady_clock::now();
+            const int passes = solve(first, last);
+            const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            for (size_t i = first; i < last; ++i)
+                report(tables[i], log);
+            log << "  " << passes << " passes, " << std::fixed << std::setprecision(1) << sec << " s\n";
+            first = last;
+        }
+    }
+
+    // Функция write() записывает построенные таблицы в файл path
+    void write(const std::string &path) const
+    {
+        std::ofstream fout(path, std::ios::binary);
+        if (!fout)
+            throw std::runtime_error("cannot open " + path);
+        TBFileHeader header{};
+        std::copy(TB_MAGIC, TB_MAGIC + sizeof(TB_MAGIC), header.magic);
+        header.version = TB_VERSION;
+        header.max_pieces = uint32_t(pieces);
+        header.table_count = uint32_t(tables.size());
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        uint64_t offset = sizeof(header) + tables.size() * sizeof(TBFileEntry);
+        std::vector<uint64_t> offsets;
+        for (const Table &table : tables)
+        {
+            offset = (offset + 7) / 8 * 8;
+            offsets.push_back(offset);
+            TBFileEntry entry{};
+            for (int side = 0; side < 2; ++side)
+            {
+                entry.men[side] = uint8_t(table.material.men[side]);
+                entry.kings[side] = uint8_t(table.material.kings[side]);
+            }
+            entry.offset = offset;
+            entry.size = table.values.size();
+            fout.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+            offset += entry.size;
+        }
+        uint64_t pos = sizeof(header) + tables.size() * sizeof(TBFileEntry);
+        for (size_t i = 0; i < tables.size(); ++i)
+        {
+            const std::vector<char> padding(offsets[i] - pos, 0);
+            fout.write(padding.data(), std::streamsize(padding.size()));
+            fout.write(reinterpret_cast<const char *>(tables[i].values.data()),
+                       std::streamsize(tables[i].values.size()));
+            pos = offsets[i] + tables[i].values.size();
+        }
+        if (!fout)
+            throw std::runtime_error("cannot write " + path);
+    }
+
+  private:
+    struct Table
+    {
+        TBMaterial material;
+        std::vector<uint8_t> values;
+    };
+
+    // Порядок решения таблиц: ход ведет только в таблицы с тем же или меньшим номером
+    static int stage_of(const TBMaterial &m)
+    {
+        return m.pieces() * (TB_MAX_PIECES + 1) + m.men[0] + m.men[1];
+    }
+
+    // Функция value() возвращает значение позиции pos (ход любой стороны) в таблицах.
+    // Таблицы решаемой группы в это время меняются другими потоками, поэтому байт читается атомарно.
+    uint8_t value(const Position &pos) const
+    {
+        const TBKey key = TBKey::of(pos);
+        if (!(key.men[0] | key.kings[0]))
+            return 1;  // Фигур не осталось - проигрыш сразу
+        uint8_t &cell = directory[key.material().slot()][key.index()];
+        return std::atomic_ref<uint8_t>(cell).load(std::memory_order_relaxed);
+    }
+
+    // Функция resolve() проверяет на проходе k еще не решенную позицию pos.
+    // Возвращает ее значение, если она решена ровно за k ходов, иначе 0.
+    uint8_t resolve(Position &pos, const int k) const
+    {
+        MoveList turns;
+        generate_turns(pos, turns);
+        for (const Move &turn : turns)
+        {
+            const Undo undo = pos.make_move(turn);
+            pos.pass_turn();
+            const uint8_t next = value(pos);
+            pos.pass_turn();
+            pos.unmake_move(turn, undo);
+            if (k % 2)
+            {
+                // Нечетный k: ищем ход в проигрыш соперника ровно за k - 1 ходов
+                if (next == k)
+                    return uint8_t(k + 1);
+            }
+            // Четный k: все ходы должны вести в выигрыши соперника (четное значение) не дольше k - 1 ходов
+            else if (next == 0 || next == TB_INVALID || next % 2 || next > k)
+                return 0;
+        }
+        return k % 2 ? 0 : uint8_t(k + 1);
+    }
+
+    // Функция for_each_chunk() выполняет task(table, begin, end) для всех позиций таблиц [first, last)
+    // по частям в потоках пула. task возвращает число измененных позиций, функция - их сумму.
+    template <class F> uint64_t for_each_chunk(const size_t first, const size_t last, const F &task)
+    {
+        const uint64_t chunk = 1 << 14;
+        std::vector<std::pair<size_t, uint64_t>> chunks;
+        for (size_t i = first; i < last; ++i)
+            for (uint64_t begin = 0; begin < tables[i].values.size(); begin += chunk)
+                chunks.emplace_back(i, begin);
+        std::atomic<uint64_t> changed(0);
+        pool.run(int(chunks.size()), [&](const int c, unsigned) {
+            Table &table = tables[chunks[c].first];
+            const uint64_t begin = chunks[c].second;
+            const uint64_t end = std::min<uint64_t>(begin + chunk, table.values.size());
+            changed += task(table, begin, end);
+        });
+        return changed;
+    }
+
+    // Функция solve() решает группу таблиц [first, last). Возвращает число проходов.
+    int solve(const size_t first, const size_t last)
+    {
+        // Невозможные расстановки: фигуры разных групп на одной клетке
+        for_each_chunk(first, last, [](Table &table, const uint64_t begin, const uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                const TBKey key = TBKey::from_index(table.material, i);
+                if (std::popcount(key.men[0] | key.men[1] | key.kings[0] | key.kings[1]) != table.material.pieces())
+                    table.values[i] = TB_INVALID;
+            }
+            return uint64_t(0);
+        });
+
+        int k = 0;
+        for (int quiet = 0;; ++k)
+        {
+            if (k > TB_MAX_DISTANCE)
+                throw std::runtime_error("tablebase distance does not fit in a byte");
+            const uint64_t changed =
+                for_each_chunk(first, last, [&](Table &table, const uint64_t begin, const uint64_t end) {
+                    uint64_t count = 0;
+                    for (uint64_t i = begin; i < end; ++i)
+                    {
+                        if (table.values[i] != 0)
+                            continue;
+                        Position pos = TBKey::from_index(table.material, i).position();
+                        const uint8_t v = resolve(pos, k);
+                        if (v)
+                        {
+                            std::atomic_ref<uint8_t>(table.values[i]).store(v, std::memory_order_relaxed);
+                            ++count;
+                        }
+                    }
+                    return count;
+                });
+            quiet = changed ? 0 : quiet + 1;
+            // Два прохода без изменений после самых длинных результатов готовых таблиц - дальше решать нечего
+            if (quiet >= 2 && k > max_distance + 1)
+                break;
+        }
+        for (size_t i = first; i < last; ++i)
+            for (const uint8_t v : tables[i].values)
+                if (v != 0 && v != TB_INVALID)
+                    max_distance = std::max(max_distance, v - 1);
+        return k + 1;
+    }
+
+    // Функция report() печатает соотношение фигур таблицы (сторона, которая ходит, - первая:
+    // 'W' - дамка, 'w' - шашка) и число выигрышей, проигрышей и ничьих в ней
+    static void report(const Table &table, std::ostream &log)
+    {
+        const TBMaterial &m = table.material;
+        uint64_t wins = 0, losses = 0, draws = 0;
+        int longest = 0;
+        for (const uint8_t v : table.values)
+        {
+            if (v == TB_INVALID)
+                continue;
+            if (v == 0)
+                ++draws;
+            else if ((v - 1) % 2)
+                ++wins;
+            else
+                ++losses;
+            if (v != 0)
+                longest = std::max(longest, v - 1);
+        }
+        log << std::string(m.kings[0], 'W') + std::string(m.men[0], 'w') << " v "
+            << std::string(m.kings[1], 'B') + std::string(m.men[1], 'b') << ": " << wins << " wins, " << losses
+            << " losses, " << draws << " draws, longest " << longest << " moves\n";
+    }
+
+    int pieces;
+    ThreadPool pool;
+    std::vector<Table> tables;  // В порядке решения
+    std::vector<uint8_t *> directory;  // Данные таблиц по TBMaterial::slot()
+    int max_distance = 0;  // Наибольшее число ходов до конца в решенных таблицах
+};
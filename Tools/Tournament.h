@@ -0,0 +1,199 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../Engine/Engine.h"
+#include "../Engine/ThreadPool.h"
+
+// Структура TournamentPlayer - участник матча: настройки бота и его уровень
+struct TournamentPlayer
+{
+    EngineSettings settings;
+    int level = 5;
+};
+
+// Структура PlayerStats - затраты участника на ходы за весь матч
+struct PlayerStats
+{
+    uint64_t moves = 0;  // Число ходов (вместе с ходами из книги и единственными ходами)
+    uint64_t nodes = 0;  // Узлы поиска вместе с узлами за горизонтом
+    double seconds = 0;  // Время на ходы
+
+    PlayerStats &operator+=(const PlayerStats &other)
+    {
+        moves += other.moves;
+        nodes += other.nodes;
+        seconds += other.seconds;
+        return *this;
+    }
+};
+
+// Структура MatchResult - итог матча с точки зрения первого участника
+struct MatchResult
+{
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    PlayerStats players[2];
+
+    int games() const
+    {
+        return wins + draws + losses;
+    }
+
+    // Функция score() возвращает долю набранных первым участником очков (победа - 1, ничья - 0.5)
+    double score() const
+    {
+        return games() ? (wins + 0.5 * draws) / games() : 0.5;
+    }
+};
+
+// Функция elo_difference() переводит долю очков score в разницу рейтингов Эло
+inline double elo_difference(const double score)
+{
+    const double s = std::clamp(score, 1e-6, 1 - 1e-6);
+    return -400 * std::log10(1 / s - 1);
+}
+
+// Функция elo_error() возвращает половину 95% доверительного интервала разницы рейтингов:
+// доля очков считается нормально распределенной с дисперсией, оцененной по исходам партий
+inline double elo_error(const MatchResult &res)
+{
+    const int n = res.games();
+    if (n == 0)
+        return 0;
+    const double p = res.score();
+    const double variance =
+        (res.wins * (1 - p) * (1 - p) + res.draws * (0.5 - p) * (0.5 - p) + res.losses * p * p) / n;
+    const double margin = 1.96 * std::sqrt(variance / n);
+    return (elo_difference(p + margin) - elo_difference(p - margin)) / 2;
+}
+
+// Функция random_opening() делает plies случайных ходов из начальной позиции.
+// Если партия закончилась раньше (так бывает только при большом plies), дебют выбирается заново.
+template <class Rng> Position random_opening(const int plies, Rng &rng)
+{
+    while (true)
+    {
+        Position pos = Position::start();
+        int ply = 0;
+        for (; ply < plies; ++ply)
+        {
+            MoveList turns;
+            generate_turns(pos, turns);
+            if (turns.empty())
+                break;
+            pos.make_move(turns[std::uniform_int_distribution<int>(0, turns.size - 1)(rng)]);
+            pos.pass_turn();
+        }
+        MoveList turns;
+        generate_turns(pos, turns);
+        if (ply == plies && !turns.empty())
+            return pos;
+    }
+}
+
+// Класс Match - матч двух ботов без окна. Партии идут парами из одного случайного дебюта
+// со сменой цвета, так что ни дебют, ни цвет не дают преимущества одному из участников.
+// Пары партий делятся между потоками пула, у каждого потока свои боты, а таблицы транспозиций
+// очищаются перед каждой партией, поэтому партия не зависит от того, какой поток ее сыграл.
+class Match
+{
+  public:
+    Match(const TournamentPlayer &first, const TournamentPlayer &second, const unsigned threads)
+        : players{first, second}, pool(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    {
+        for (unsigned worker = 0; worker < pool.size(); ++worker)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                EngineSettings settings = players[side].settings;
+                settings.seed += 1024 * (2 * worker + unsigned(side));
+                engines.push_back(std::make_unique<Engine>(settings));
+            }
+        }
+    }
+
+    // Функция run() играет pairs пар партий из дебютов по opening_plies случайных ходов
+    // (дебюты зависят только от seed), партия длиннее max_turns ходов - ничья.
+    // После каждой десятой части партий печатает в log промежуточный счет.
+    MatchResult run(const int pairs, const int opening_plies, const int max_turns, const unsigned seed,
+                    std::ostream &log)
+    {
+        MatchResult res;
+        std::mutex mutex;
+        const int report_every = std::max(1, pairs / 10);
+        int finished = 0;
+        pool.run(pairs, [&](const int pair, const unsigned worker) {
+            std::default_random_engine rng(seed + unsigned(pair));
+            const Position opening = random_opening(opening_plies, rng);
+            MatchResult local;
+            for (int first_color = 0; first_color < 2; ++first_color)
+            {
+                // first_color - цвет первого участника в этой партии
+                Engine *bots[2] = {engines[2 * worker + first_color].get(),
+                                   engines[2 * worker + 1 - first_color].get()};
+                const int levels[2] = {players[first_color].level, players[1 - first_color].level};
+                PlayerStats stats[2];
+                const int winner = play(opening, bots, levels, opening_plies, max_turns, stats);
+                local.players[0] += stats[first_color];
+                local.players[1] += stats[1 - first_color];
+                if (winner == -1)
+                    ++local.draws;
+                else if (winner == first_color)
+                    ++local.wins;
+                else
+                    ++local.losses;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            res.wins += local.wins;
+            res.draws += local.draws;
+            res.losses += local.losses;
+            res.players[0] += local.players[0];
+            res.players[1] += local.players[1];
+            if (++finished % report_every == 0 || finished == pairs)
+                log << res.games() << " games: +" << res.wins << " =" << res.draws << " -" << res.losses << '\n';
+        });
+        return res;
+    }
+
+  private:
+    // Функция play() играет партию из позиции opening, в которой уже сделано turn_num ходов.
+    // bots и levels - боты и уровни белых и черных, stats - их затраты.
+    // Возвращает цвет победителя или -1 при ничьей.
+    static int play(Position pos, Engine *bots[2], const int levels[2], int turn_num, const int max_turns,
+                    PlayerStats stats[2])
+    {
+        bots[0]->new_game();
+        bots[1]->new_game();
+        for (; turn_num < max_turns; ++turn_num)
+        {
+            MoveList turns;
+            generate_turns(pos, turns);
+            if (turns.empty())
+                return !pos.color;
+            Engine &bot = *bots[pos.color];
+            const auto start = std::chrono::steady_clock::now();
+            const auto steps = bot.find_best_turns(pos, levels[pos.color]);
+            stats[pos.color].seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            stats[pos.color].nodes += bot.stats().nodes;
+            ++stats[pos.color].moves;
+            for (const move_pos &step : steps)
+                pos.make_move(Move::from_move_pos(step));
+            pos.pass_turn();
+        }
+        return -1;
+    }
+
+    TournamentPlayer players[2];
+    ThreadPool pool;
+    std::vector<std::unique_ptr<Engine>> engines;  // Боты участников для каждого потока: [2 * поток + участник]
+};
@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../Engine/Engine.h"
+#include "../Engine/ThreadPool.h"
+#include "Tournament.h"
+
+// Структура TuningSample - позиция из партии для настройки оценки: признаки сторон и итог партии
+struct TuningSample
+{
+    int16_t terms[2][EVAL_TERMS];  // Признаки белых и черных (см. eval_terms)
+    float result;  // Итог для белых: 1 - победа, 0.5 - ничья, 0 - поражение
+};
+
+// Класс Tuner подбирает веса оценки "Tuned" методом Texel: по позициям из партий бота с самим собой
+// минимизируется средний квадрат разности итога партии и ожидаемого результата 1 / (1 + exp(-k * q)),
+// где q = (W - B) / (W + B) - оценка позиции для белых без масштаба SCORE_SCALE.
+// Берутся только позиции без взятия на очереди: в остальных статическая оценка не отражает позицию.
+// Веса меняются по одному (покоординатный спуск) с шагом, который уменьшается вдвое, пока ошибка падает.
+// Ошибка считается по частям в потоках пула, и части складываются по порядку, так что результат
+// не зависит от числа потоков.
+class Tuner
+{
+  public:
+    explicit Tuner(const unsigned threads)
+        : pool(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    {
+    }
+
+    // Функция collect() играет games партий бота с настройками settings на уровне level с самим собой
+    // из дебютов по opening_plies случайных ходов (партия длиннее max_turns ходов - ничья)
+    // и добавляет их позиции к выборке
+    void collect(const EngineSettings &settings, const int games, const int level, const int opening_plies,
+                 const int max_turns, const unsigned seed)
+    {
+        std::vector<std::unique_ptr<Engine>> engines;
+        for (unsigned worker = 0; worker < pool.size(); ++worker)
+        {
+            EngineSettings worker_settings = settings;
+            worker_settings.seed += 1024 * worker;
+            engines.push_back(std::make_unique<Engine>(worker_settings));
+        }
+        std::vector<std::vector<TuningSample>> game_samples(static_cast<size_t>(games));
+        pool.run(games, [&](const int game, const unsigned worker) {
+            std::default_random_engine rng(seed + unsigned(game));
+            Position pos = random_opening(opening_plies, rng);
+            Engine &engine = *engines[worker];
+            engine.new_game();
+            std::vector<TuningSample> &positions = game_samples[size_t(game)];
+            float result = 0.5f;
+            for (int turn_num = opening_plies; turn_num < max_turns; ++turn_num)
+            {
+                MoveList turns;
+                generate_turns(pos, turns);
+                if (turns.empty())
+                {
+                    result = pos.color ? 1.0f : 0.0f;
+                    break;
+                }
+                MoveList captures;
+                if (!generate_capture_sequences(pos, captures))
+                {
+                    int terms[2][EVAL_TERMS];
+                    eval_terms(pos, terms);
+                    TuningSample sample;
+                    for (int side = 0; side < 2; ++side)
+                        for (int term = 0; term < EVAL_TERMS; ++term)
+                            sample.terms[side][term] = int16_t(terms[side][term]);
+                    positions.push_back(sample);
+                }
+                for (const move_pos &step : engine.find_best_turns(pos, level))
+                    pos.make_move(Move::from_move_pos(step));
+                pos.pass_turn();
+            }
+            for (TuningSample &sample : positions)
+                sample.result = result;
+        });
+        // Позиции складываются в порядке партий, а не их завершения: от порядка зависит сумма ошибок
+        for (const auto &positions : game_samples)
+            samples.insert(samples.end(), positions.begin(), positions.end());
+    }
+
+    // Функция size() возвращает число позиций в выборке
+    size_t size() const
+    {
+        return samples.size();
+    }
+
+    // Функция error() возвращает среднюю ошибку весов weights при масштабе k
+    double error(const EvalWeights &weights, const double k)
+    {
+        const size_t chunk = 1 << 14;
+        const int chunks = int((samples.size() + chunk - 1) / chunk);
+        std::vector<double> sums(size_t(chunks), 0.0);
+        pool.run(chunks, [&](const int c, unsigned) {
+            const size_t end = std::min(samples.size(), size_t(c + 1) * chunk);
+            double sum = 0;
+            for (size_t i = size_t(c) * chunk; i < end; ++i)
+            {
+                int terms[2][EVAL_TERMS];
+                for (int side = 0; side < 2; ++side)
+                    for (int term = 0; term < EVAL_TERMS; ++term)
+                        terms[side][term] = samples[i].terms[side][term];
+                const double w = weights.strength(terms[0]), b = weights.strength(terms[1]);
+                const double expected = 1 / (1 + std::exp(-k * (w - b) / (w + b)));
+                sum += (samples[i].result - expected) * (samples[i].result - expected);
+            }
+            sums[size_t(c)] = sum;
+        });
+        double total = 0;
+        for (const double sum : sums)
+            total += sum;
+        return samples.empty() ? 0 : total / double(samples.size());
+    }
+
+    // Функция fit_scale() подбирает масштаб k, при котором ошибка весов weights наименьшая
+    // (золотое сечение на отрезке [0, 50]: ошибка от k унимодальна)
+    double fit_scale(const EvalWeights &weights)
+    {
+        const double ratio = (std::sqrt(5.0) - 1) / 2;
+        double lo = 0, hi = 50;
+        for (int iter = 0; iter < 40; ++iter)
+        {
+            const double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+            if (error(weights, a) < error(weights, b))
+                hi = b;
+            else
+                lo = a;
+        }
+        return (lo + hi) / 2;
+    }
+
+    // Функция tune() подбирает веса, начиная с weights, и печатает в log веса после каждого шага.
+    // Вес шашки не меняется: он задает масштаб (оценка зависит только от отношения весов).
+    EvalWeights tune(EvalWeights weights, std::ostream &log)
+    {
+        double k = fit_scale(weights);
+        double best = error(weights, k);
+        log << "Scale " << k << ", error " << best << '\n';
+        for (int step = 64; step >= 1; step /= 2)
+        {
+            bool improved = true;
+            while (improved)
+            {
+                improved = false;
+                for (int term = TERM_MAN + 1; term < EVAL_TERMS; ++term)
+                {
+                    for (const int delta : {step, -step})
+                    {
+                        EvalWeights next = weights;
+                        next.w[term] = std::max(next.w[term] + delta, term == TERM_KING ? 1 : 0);
+                        if (next.w[term] == weights.w[term])
+                            continue;
+                        const double e = error(next, k);
+                        if (e < best)
+                        {
+                            best = e;
+                            weights = next;
+                            improved = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            // Масштаб подбирается заново после каждого шага: иначе веса растут, чтобы заменить его
+            k = fit_scale(weights);
+            best = error(weights, k);
+            log << "Step " << step << ':';
+            for (int term = 0; term < EVAL_TERMS; ++term)
+                log << ' ' << EVAL_TERM_NAMES[term] << ' ' << weights.w[term];
+            log << ", scale " << k << ", error " << best << '\n';
+        }
+        return weights;
+    }
+
+  private:
+    ThreadPool pool;
+    std::vector<TuningSample> samples;
+};
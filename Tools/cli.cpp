@@ -0,0 +1,569 @@
+// Консольная программа для работы с движком без окна (для серверов без дисплея):
+// игры бота с ботом, матчи разных настроек бота, проверка генератора ходов, замер скорости поиска,
+// построение эндшпильных баз и дебютной книги, настройка весов оценки.
+// Использует только движок из каталога Engine, SDL и nlohmann/json ей не нужны.
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../Engine/Engine.h"
+#include "../Engine/Perft.h"
+#include "BenchSuite.h"
+#include "BookGen.h"
+#include "PerftSuite.h"
+#include "TablebaseGen.h"
+#include "Tournament.h"
+#include "Tuner.h"
+
+namespace
+{
+// Настройки игры из командной строки
+struct Options
+{
+    EngineSettings engine;
+    int white_level = 5;
+    int black_level = 5;
+    int max_turns = 120;
+    int games = 1;
+    bool print_moves = false;
+    int depth = 8;  // Глубина perft
+    std::string position;  // Позиция для perft (пусто - набор PERFT_SUITE)
+    int level = -1;  // Уровень бота для bench (-1 - уровни из BENCH_SUITE), book (-1 - 8) и tune (-1 - 4)
+    int pieces = 4;  // Наибольшее число фигур в эндшпильных базах для tbgen
+    int plies = 10;  // Сколько первых ходов каждой партии попадает в книгу для book (для match - случайный дебют)
+    std::string first = "level=5", second = "level=5";  // Участники match (см. parse_player)
+    std::string output;  // Файл, который записывают tbgen, book и tune (пусто - tablebase.bin, book.bin, weights.txt)
+};
+
+void print_usage()
+{
+    std::cerr << "Usage: checkers_cli play [options]\n"
+                 "       checkers_cli perft [--depth N] [--position POS]\n"
+                 "       checkers_cli bench [--level N] [engine options]\n"
+                 "       checkers_cli tbgen [--pieces N] [--threads N] [--out FILE]\n"
+                 "       checkers_cli book [--games N] [--plies N] [--level N] [--threads N] [--out FILE]\n"
+                 "       checkers_cli match --first SPEC --second SPEC [--games N] [--plies N] [--threads N]\n"
+                 "       checkers_cli tune [--games N] [--level N] [--plies N] [--threads N] [--out FILE]\n"
+                 "play - bot vs bot games:\n"
+                 "  --games N            number of bot vs bot games (1)\n"
+                 "  --white-level N      white bot level (5)\n"
+                 "  --black-level N      black bot level (5)\n"
+                 "  --max-turns N        turns before a draw (120)\n"
+                 "  --scoring TYPE       NumberOnly, NumberAndPotential or Tuned (NumberAndPotential)\n"
+                 "  --optimization O     O0, O1 or O2 (O1)\n"
+                 "  --time-ms N          time budget per move, 0 - no limit (0)\n"
+                 "  --threads N          search threads, 0 - one per core (1)\n"
+                 "  --hash-mb N          transposition table size (64)\n"
+                 "  --quiescence N       plies of forced captures searched past the level, 0 - none (8)\n"
+                 "  --tablebase FILE     endgame tablebase file built by tbgen (none)\n"
+                 "  --book FILE          opening book file built by book (none)\n"
+                 "  --weights FILE       weights of the Tuned scoring written by tune (defaults)\n"
+                 "  --no-random          deterministic bots\n"
+                 "  --moves              print every move\n"
+                 "perft - count positions to depth N and compare with the reference counts:\n"
+                 "  --depth N            maximum depth (8)\n"
+                 "  --position POS       position like \"w bbbb/bbbb/bbbb/..../..../wwww/wwww/wwww\"\n"
+                 "                       (default - the stored positions with reference counts)\n"
+                 "bench - search the stored positions and print the statistics as JSON:\n"
+                 "  --level N            bot level for every position (default - the stored levels)\n"
+                 "  --scoring, --optimization, --time-ms, --threads, --hash-mb, --quiescence, --tablebase\n"
+                 "  as for play, the bots are always deterministic\n"
+                 "tbgen - build endgame tablebases by retrograde analysis:\n"
+                 "  --pieces N           all positions with up to N pieces (4)\n"
+                 "  --threads N          generation threads, 0 - one per core (0)\n"
+                 "  --out FILE           output file (tablebase.bin)\n"
+                 "book - build an opening book: every move near the best one in the searched positions,\n"
+                 "       positions reached by random games along the book moves:\n"
+                 "  --games N            number of games (200)\n"
+                 "  --plies N            moves of every game stored in the book (10)\n"
+                 "  --level N            bot level (8)\n"
+                 "  --threads N          games played in parallel, 0 - one per core (0)\n"
+                 "  --out FILE           output file (book.bin)\n"
+                 "  --scoring, --optimization, --hash-mb, --quiescence, --tablebase as for play\n"
+                 "match - games between two bot settings from the same random openings with colors swapped,\n"
+                 "        prints wins/draws/losses of the first, the Elo difference and the search costs:\n"
+                 "  --first SPEC         first bot, comma separated key=value: level, scoring, optimization,\n"
+                 "                       quiescence, time-ms, hash-mb, threads, tablebase, book, weights (level=5)\n"
+                 "  --second SPEC        second bot (level=5)\n"
+                 "  --games N            number of games, rounded up to pairs (1000)\n"
+                 "  --plies N            random moves of every opening (4)\n"
+                 "  --max-turns N        turns before a draw (120)\n"
+                 "  --threads N          games played in parallel, 0 - one per core (0)\n"
+                 "  --scoring, --optimization, --hash-mb, --quiescence, --tablebase, --book, --no-random\n"
+                 "  the defaults of both bots (hash 16 MB, one search thread each)\n"
+                 "tune - fit the weights of the Tuned scoring to the results of self-play games (Texel method):\n"
+                 "  --games N            number of games (1000)\n"
+                 "  --level N            bot level (4)\n"
+                 "  --plies N            random moves of every opening (4)\n"
+                 "  --max-turns N        turns before a draw (120)\n"
+                 "  --threads N          games played in parallel, 0 - one per core (0)\n"
+                 "  --weights FILE       starting weights (defaults, equal to NumberAndPotential)\n"
+                 "  --out FILE           output file (weights.txt)\n"
+                 "  --scoring, --optimization, --hash-mb, --quiescence, --tablebase, --book\n"
+                 "  settings of the bot that plays the games\n";
+}
+
+// Функция parse_options() разбирает аргументы вида --name value.
+// Возвращает false при ошибке (неизвестные названия оценки и оптимизации бросают std::invalid_argument).
+bool parse_options(const int argc, char *argv[], Options &opt)
+{
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string name = argv[i];
+        if (name == "--no-random")
+        {
+            opt.engine.no_random = true;
+            continue;
+        }
+        if (name == "--moves")
+        {
+            opt.print_moves = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        const std::string value = argv[++i];
+        if (name == "--games")
+            opt.games = std::atoi(value.c_str());
+        else if (name == "--white-level")
+            opt.white_level = std::atoi(value.c_str());
+        else if (name == "--black-level")
+            opt.black_level = std::atoi(value.c_str());
+        else if (name == "--max-turns")
+            opt.max_turns = std::atoi(value.c_str());
+        else if (name == "--scoring")
+            opt.engine.scoring = scoring_from_string(value);
+        else if (name == "--optimization")
+            opt.engine.optimization = optimization_from_string(value);
+        else if (name == "--time-ms")
+            opt.engine.time_limit_ms = std::atoi(value.c_str());
+        else if (name == "--threads")
+            opt.engine.threads = unsigned(std::atoi(value.c_str()));
+        else if (name == "--hash-mb")
+            opt.engine.hash_size_mb = size_t(std::atoi(value.c_str()));
+        else if (name == "--quiescence")
+            opt.engine.quiescence_limit = std::atoi(value.c_str());
+        else if (name == "--tablebase")
+            opt.engine.tablebase_path = value;
+        else if (name == "--book")
+            opt.engine.book_path = value;
+        else if (name == "--weights")
+            opt.engine.weights_path = value;
+        else if (name == "--first")
+            opt.first = value;
+        else if (name == "--second")
+            opt.second = value;
+        else if (name == "--plies")
+            opt.plies = std::atoi(value.c_str());
+        else if (name == "--pieces")
+            opt.pieces = std::atoi(value.c_str());
+        else if (name == "--out")
+            opt.output = value;
+        else if (name == "--depth")
+            opt.depth = std::atoi(value.c_str());
+        else if (name == "--position")
+            opt.position = value;
+        else if (name == "--level")
+            opt.level = std::atoi(value.c_str());
+        else
+            return false;
+    }
+    return true;
+}
+
+// Функция parse_player() разбирает участника матча spec вида "level=6,scoring=NumberOnly":
+// не указанные настройки берутся из base. Неизвестный ключ бросает std::invalid_argument.
+TournamentPlayer parse_player(const std::string &spec, const EngineSettings &base)
+{
+    TournamentPlayer player;
+    player.settings = base;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        const size_t eq = item.find('=');
+        if (eq == std::string::npos)
+            throw std::invalid_argument("expected key=value: " + item);
+        const std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+        if (key == "level")
+            player.level = std::atoi(value.c_str());
+        else if (key == "scoring")
+            player.settings.scoring = scoring_from_string(value);
+        else if (key == "optimization")
+            player.settings.optimization = optimization_from_string(value);
+        else if (key == "quiescence")
+            player.settings.quiescence_limit = std::atoi(value.c_str());
+        else if (key == "time-ms")
+            player.settings.time_limit_ms = std::atoi(value.c_str());
+        else if (key == "hash-mb")
+            player.settings.hash_size_mb = size_t(std::atoi(value.c_str()));
+        else if (key == "threads")
+            player.settings.threads = unsigned(std::atoi(value.c_str()));
+        else if (key == "tablebase")
+            player.settings.tablebase_path = value;
+        else if (key == "book")
+            player.settings.book_path = value;
+        else if (key == "weights")
+            player.settings.weights_path = value;
+        else
+            throw std::invalid_argument("unknown bot setting: " + key);
+    }
+    return player;
+}
+
+// Функция turn_to_string() записывает ход с серией взятий как координаты клеток (строка и столбец),
+// например "52-43" для хода без взятия или "52x34x16" для серии из двух взятий
+std::string turn_to_string(const std::vector<move_pos> &turns)
+{
+    std::string res;
+    for (const move_pos &turn : turns)
+    {
+        if (res.empty())
+            res += std::to_string(turn.x) + std::to_string(turn.y);
+        res += (turn.xb != -1 ? 'x' : '-') + std::to_string(turn.x2) + std::to_string(turn.y2);
+    }
+    return res;
+}
+
+// Функция play_game() играет одну партию бота с ботом по правилам Game::play().
+// Возвращает результат в кодировке Board::show_final(): 0 - ничья, 1 - победа белых, 2 - победа черных.
+int play_game(Engine &white, Engine &black, const Options &opt, int &turn_num)
+{
+    Position pos = Position::start();
+    turn_num = -1;
+    while (++turn_num < opt.max_turns)
+    {
+        bool have_beats;
+        if (Engine::find_turns(pos, have_beats).empty())
+            break;
+        Engine &engine = pos.color ? black : white;
+        const auto turns = engine.find_best_turns(pos, pos.color ? opt.black_level : opt.white_level);
+        for (const move_pos &turn : turns)
+            pos.make_move(Move::from_move_pos(turn));
+        if (opt.print_moves)
+            std::cout << turn_to_string(turns) << '\n';
+        pos.pass_turn();
+    }
+    if (turn_num == opt.max_turns)
+        return 0;
+    return turn_num % 2 ? 1 : 2;
+}
+
+// Функция warn_missing_files() сообщает, какие файлы из настроек settings бот не сможет загрузить.
+// Файлы проверяются теми же функциями load(), что и в Engine, но без создания бота
+// (таблицы транспозиций и потоков поиска), и сразу закрываются.
+void warn_missing_files(const EngineSettings &settings)
+{
+    if (!settings.tablebase_path.empty() && !Tablebase().load(settings.tablebase_path))
+        std::cerr << "Cannot load tablebase " << settings.tablebase_path << ", playing without it\n";
+    if (!settings.book_path.empty() && !Book().load(settings.book_path))
+        std::cerr << "Cannot load opening book " << settings.book_path << ", playing without it\n";
+    if (!settings.weights_path.empty() && !EvalWeights().load(settings.weights_path))
+        std::cerr << "Cannot load weights " << settings.weights_path << ", playing with the default ones\n";
+}
+
+// Функция run_play() выполняет команду play
+int run_play(Options opt)
+{
+    if (!opt.engine.no_random)
+        opt.engine.seed = unsigned(std::time(nullptr));
+
+    warn_missing_files(opt.engine);
+    int results[3] = {0, 0, 0};
+    for (int game = 1; game <= opt.games; ++game)
+    {
+        // Каждая партия начинается с пустых таблиц, как новая игра в окне.
+        // Зерна разные у всех ботов и партий, иначе без NoRandom партии повторялись бы
+        EngineSettings white_settings = opt.engine, black_settings = opt.engine;
+        if (!opt.engine.no_random)
+        {
+            white_settings.seed += 2 * 1024 * unsigned(game);
+            black_settings.seed += 2 * 1024 * unsigned(game) + 1024;
+        }
+        Engine white(white_settings), black(black_settings);
+        const auto start = std::chrono::steady_clock::now();
+        int turns = 0;
+        const int res = play_game(white, black, opt, turns);
+        const auto end = std::chrono::steady_clock::now();
+        ++results[res];
+        std::cout << "Game " << game << ": " << (res == 0 ? "draw" : res == 1 ? "white wins" : "black wins")
+                  << " after " << turns << " turns, "
+                  << int(std::chrono::duration<double, std::milli>(end - start).count()) << " ms\n";
+    }
+    std::cout << "White wins: " << results[1] << ", black wins: " << results[2] << ", draws: " << results[0]
+              << '\n';
+    return 0;
+}
+
+// Функция perft_position() считает perft позиции pos на глубинах от 1 до depth,
+// печатает число позиций и скорость и сверяет с эталоном expected (если он задан для этой глубины).
+// Возвращает false при расхождении с эталоном.
+bool perft_position(const Position &pos, const int depth, const std::vector<uint64_t> &expected)
+{
+    bool ok = true;
+    for (int d = 1; d <= depth; ++d)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t nodes = perft(pos, d);
+        const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  depth " << std::setw(2) << d << std::setw(14) << nodes << " nodes " << std::setw(9)
+                  << std::fixed << std::setprecision(3) << sec << " s " << std::setw(8) << std::setprecision(2)
+                  << (sec > 0 ? nodes / sec / 1e6 : 0.0) << " Mnodes/s";
+        if (size_t(d) <= expected.size())
+        {
+            const bool match = nodes == expected[d - 1];
+            ok = ok && match;
+            std::cout << (match ? "  ok" : "  MISMATCH, expected " + std::to_string(expected[d - 1]));
+        }
+        std::cout << '\n';
+    }
+    return ok;
+}
+
+// Функция run_perft() выполняет команду perft. Возвращает 1, если хоть одно число не совпало с эталоном
+// (или не удалось разобрать позицию).
+int run_perft(const Options &opt)
+{
+    if (!opt.position.empty())
+    {
+        Position pos;
+        try
+        {
+            pos = Position::from_string(opt.position);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        std::cout << pos.to_string() << '\n';
+        perft_position(pos, opt.depth, {});
+        return 0;
+    }
+    bool ok = true;
+    for (const PerftCase &test : PERFT_SUITE)
+    {
+        std::cout << test.name << ": " << test.position << '\n';
+        ok = perft_position(Position::from_string(test.position), opt.depth, test.nodes) && ok;
+    }
+    std::cout << (ok ? "All counts match the reference\n" : "Some counts do not match the reference\n");
+    return ok ? 0 : 1;
+}
+
+// Функция run_bench() выполняет команду bench: ищет ход в каждой позиции BENCH_SUITE с новой таблицей
+// транспозиций и печатает в формате JSON число узлов (и сколько из них за горизонтом), скорость,
+// эффективный коэффициент ветвления (корень степени, равной числу ходов глубины поиска, из числа узлов),
+// долю узлов с отсечением, долю отсечений на первом ходе и выбранный ход
+int run_bench(Options opt)
+{
+    opt.engine.no_random = true;
+    SearchStats total;
+    double total_sec = 0;
+    std::cout << "{\n  \"positions\": [\n";
+    for (size_t i = 0; i < BENCH_SUITE.size(); ++i)
+    {
+        const BenchCase &test = BENCH_SUITE[i];
+        const int level = opt.level >= 0 ? opt.level : test.level;
+        Engine engine(opt.engine);
+        if (i == 0 && !opt.engine.tablebase_path.empty() && !engine.has_tablebase())
+            std::cerr << "Cannot load tablebase " << opt.engine.tablebase_path << ", searching without it\n";
+        const auto start = std::chrono::steady_clock::now();
+        const auto turns = engine.find_best_turns(Position::from_string(test.position), level);
+        const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const SearchStats stats = engine.stats();
+        total += stats;
+        total_sec += sec;
+        const int plies = engine.completed_depth() + 1;
+        std::cout << "    {\"name\": \"" << test.name << "\", \"position\": \"" << test.position
+                  << "\", \"level\": " << level << ", \"completed_level\": " << engine.completed_depth()
+                  << ", \"nodes\": " << stats.nodes << ", \"quiescence_nodes\": " << stats.qnodes
+                  << ", \"tablebase_hits\": " << stats.tbhits
+                  << ", \"time_ms\": " << std::fixed << std::setprecision(1)
+                  << sec * 1000 << ", \"nps\": " << std::setprecision(0) << (sec > 0 ? stats.nodes / sec : 0.0)
+                  << ", \"branching_factor\": " << std::setprecision(3)
+                  << (plies > 0 ? std::pow(double(stats.nodes), 1.0 / plies) : 0.0)
+                  << ", \"cutoff_rate\": " << (stats.expanded ? double(stats.cutoffs) / stats.expanded : 0.0)
+                  << ", \"first_move_cutoff_rate\": "
+                  << (stats.cutoffs ? double(stats.first_cutoffs) / stats.cutoffs : 0.0) << ", \"move\": \""
+                  << turn_to_string(turns) << "\"}" << (i + 1 < BENCH_SUITE.size() ? "," : "") << '\n';
+    }
+    std::cout << "  ],\n  \"total\": {\"nodes\": " << total.nodes << ", \"time_ms\": " << std::setprecision(1)
+              << total_sec * 1000 << ", \"nps\": " << std::setprecision(0)
+              << (total_sec > 0 ? total.nodes / total_sec : 0.0) << "}\n}\n";
+    return 0;
+}
+
+// Функция run_tbgen() выполняет команду tbgen: строит эндшпильные базы и записывает их в файл
+int run_tbgen(const Options &opt)
+{
+    try
+    {
+        TablebaseGenerator generator(opt.pieces, opt.engine.threads);
+        generator.run(std::cout);
+        generator.write(opt.output.empty() ? "tablebase.bin" : opt.output);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    std::cout << "Written " << (opt.output.empty() ? "tablebase.bin" : opt.output) << '\n';
+    return 0;
+}
+
+// Функция run_book() выполняет команду book: строит дебютную книгу по партиям бота с ботом
+int run_book(Options opt)
+{
+    if (opt.output.empty())
+        opt.output = "book.bin";
+    const auto start = std::chrono::steady_clock::now();
+    BookBuilder builder;
+    build_book(builder, opt.engine, opt.games, opt.plies, opt.level >= 0 ? opt.level : 8, opt.engine.threads,
+               unsigned(std::time(nullptr)));
+    try
+    {
+        builder.write(opt.output);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Written " << opt.output << ": " << builder.size() << " positions from " << opt.games
+              << " games, " << std::fixed << std::setprecision(1) << sec << " s\n";
+    return 0;
+}
+
+// Функция print_player_stats() печатает затраты участника матча на ход
+void print_player_stats(const std::string &name, const PlayerStats &stats)
+{
+    const double moves = double(std::max<uint64_t>(stats.moves, 1));
+    std::cout << name << ": " << stats.moves << " moves, " << std::fixed << std::setprecision(2)
+              << stats.seconds * 1000 / moves << " ms/move, " << std::setprecision(0) << stats.nodes / moves
+              << " nodes/move\n";
+}
+
+// Функция run_match() выполняет команду match: матч двух настроек бота
+int run_match(Options opt)
+{
+    // --threads задает число партий, которые идут одновременно, а каждый бот ищет в одном потоке
+    const unsigned parallel = opt.engine.threads;
+    opt.engine.threads = 1;
+    // С NoRandom зерно 0: дебюты и партии повторяются от запуска к запуску
+    if (!opt.engine.no_random)
+        opt.engine.seed = unsigned(std::time(nullptr));
+    TournamentPlayer first, second;
+    try
+    {
+        first = parse_player(opt.first, opt.engine);
+        second = parse_player(opt.second, opt.engine);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    second.settings.seed += 1;
+    const int pairs = std::max(1, (opt.games + 1) / 2);
+    std::cout << "First: " << opt.first << "\nSecond: " << opt.second << '\n';
+
+    for (const TournamentPlayer *player : {&first, &second})
+        warn_missing_files(player->settings);
+    const auto start = std::chrono::steady_clock::now();
+    Match match(first, second, parallel);
+    const MatchResult res = match.run(pairs, opt.plies, opt.max_turns, opt.engine.seed, std::cout);
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Games: " << res.games() << ", first wins " << res.wins << ", draws " << res.draws
+              << ", losses " << res.losses << " (score " << std::fixed << std::setprecision(1)
+              << res.score() * 100 << "%), " << sec << " s\n";
+    std::cout << "Elo difference: " << std::showpos << elo_difference(res.score()) << std::noshowpos << " +- "
+              << elo_error(res) << " (95%)\n";
+    print_player_stats("First", res.players[0]);
+    print_player_stats("Second", res.players[1]);
+    return 0;
+}
+
+// Функция run_tune() выполняет команду tune: подбирает веса оценки "Tuned" и записывает их в файл
+int run_tune(Options opt)
+{
+    if (opt.output.empty())
+        opt.output = "weights.txt";
+    EvalWeights weights;
+    if (!opt.engine.weights_path.empty() && !weights.load(opt.engine.weights_path))
+    {
+        std::cerr << "Cannot load weights " << opt.engine.weights_path << '\n';
+        return 1;
+    }
+    const unsigned parallel = opt.engine.threads;
+    opt.engine.threads = 1;
+    opt.engine.seed = unsigned(std::time(nullptr));
+    const auto start = std::chrono::steady_clock::now();
+    Tuner tuner(parallel);
+    tuner.collect(opt.engine, opt.games, opt.level >= 0 ? opt.level : 4, opt.plies, opt.max_turns, opt.engine.seed);
+    std::cout << tuner.size() << " positions from " << opt.games << " games\n";
+    weights = tuner.tune(weights, std::cout);
+    if (!weights.save(opt.output))
+    {
+        std::cerr << "cannot write " << opt.output << '\n';
+        return 1;
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Written " << opt.output << ", " << std::fixed << std::setprecision(1) << sec << " s\n";
+    return 0;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options opt;
+    const std::string command = argc > 1 ? argv[1] : "";
+    // Базы, книга, матч и настройка весов используют все ядра, если не указано иное
+    if (command == "tbgen" || command == "book" || command == "match" || command == "tune")
+        opt.engine.threads = 0;
+    if (command == "book")
+        opt.games = 200;
+    if (command == "match" || command == "tune")
+    {
+        opt.games = 1000;
+        opt.plies = 4;
+        opt.engine.hash_size_mb = 16;
+    }
+    bool parsed = false;
+    try
+    {
+        parsed = parse_options(argc, argv, opt);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << '\n';
+    }
+    if ((command != "play" && command != "perft" && command != "bench" && command != "tbgen" &&
+         command != "book" && command != "match" &&
+         command != "tune") ||
+        !parsed)
+    {
+        print_usage();
+        return 1;
+    }
+    if (command == "perft")
+        return run_perft(opt);
+    if (command == "bench")
+        return run_bench(opt);
+    if (command == "tbgen")
+        return run_tbgen(opt);
+    if (command == "book")
+        return run_book(opt);
+    if (command == "match")
+        return run_match(opt);
+    if (command == "tune")
+        return run_tune(opt);
+    return run_play(opt);
+}